@@ -39,12 +39,10 @@
 #include "../cfillion/cfillion.hpp" // CF_ShellExecute
 #include "../reaper/localize.h"
 #include "../SnM/SnM_Dlg.h"
+#include "../SnM/SnM_Misc.h"
 #include "../Prompt.h"
 #include "WDL/projectcontext.h"
 
-#include <taglib/tag.h>
-#include <taglib/fileref.h>
-
 int GetCurrentYear(){
 	time_t t = 0;
 	struct tm *lt = NULL;
@@ -229,47 +227,68 @@ void WriteProjectFile( string filename, WDL_FastString* prjStr ){
 	delete outProject;
 }
 
-void WDLStringReplaceLine( WDL_FastString *prjStr, int pos, const char *oldLine, const char *newLine ){
-	//if newLine does't have a trailing \n, things will break because WDL_FastString will insert > at the wrong place!
-	//maybe should check for this here?
-	int lineLen = (int)strlen( oldLine ) + 1; //Add 1 for the omitted newline
-	int startPos = pos - lineLen;
-	prjStr->DeleteSub( startPos, lineLen );
-	prjStr->Insert( newLine, startPos );
-}
+struct ProjectParameter {
+	string param;
+	string paramValue;
+	string insertAfterParam; // where to insert param if it isn't found, can be empty
+};
 
-void SetProjectParameter( WDL_FastString *prjStr, string param, string paramValue, string insertAfterParam ){
+// Single pass over the project: replaces the first line of each param, or inserts it after
+// the first insertAfterParam line when the param isn't found (untouched lines are copied as is)
+void SetProjectParameters( WDL_FastString *prjStr, const vector<ProjectParameter> &params ){
 	char line[4096];
-	int pos = 0;
+	int pos = 0, lineStart = 0;
 	LineParser lp(false);
-	string paramString = param + string(" ") + paramValue + string("\n");
+	WDL_FastString outStr;
+	vector<bool> found( params.size(), false );
+	vector<int> insertPos( params.size(), -1 ); // offset in outStr, right after the insertAfterParam line
 
 	while (GetChunkLine(prjStr->Get(), line, 4096, &pos, false)){
+		const char *firstToken = NULL;
+		bool replaced = false;
 		if( !lp.parse( line ) && lp.getnumtokens() ) {
-			if ( strcmp( lp.gettoken_str(0), param.c_str() ) == 0) {
-				WDLStringReplaceLine(prjStr, pos, line, paramString.c_str());
-				return;
+			firstToken = lp.gettoken_str(0);
+			for (unsigned int i = 0; i < params.size(); i++) {
+				if (!found[i] && params[i].param == firstToken) {
+					found[i] = true;
+					replaced = true;
+					outStr.Append( (params[i].param + " " + params[i].paramValue + "\n").c_str() );
+					break;
+				}
 			}
 		}
-	}
+		if (!replaced)
+			outStr.Append( prjStr->Get() + lineStart, pos - lineStart );
 
-	if (!insertAfterParam.empty()) {
-		//param wasn't found, insert after insertAfterParam
-		pos = 0;
-		while (GetChunkLine(prjStr->Get(), line, 4096, &pos, false)){
-			if (!lp.parse(line) && lp.getnumtokens()) {
-				if (strcmp(lp.gettoken_str(0), insertAfterParam.c_str()) == 0) {
-					string replacementStr = line + string("\n") + paramString;
-					WDLStringReplaceLine(prjStr, pos, line, replacementStr.c_str());
-					return;
-				}
-			}
+		if (firstToken) {
+			for (unsigned int i = 0; i < params.size(); i++)
+				if (insertPos[i] < 0 && !params[i].insertAfterParam.empty() && params[i].insertAfterParam == firstToken)
+					insertPos[i] = outStr.GetLength();
 		}
+		lineStart = pos;
+	}
+
+	// params that weren't found, inserted from the end so that offsets remain valid
+	for (int i = (int)params.size() - 1; i >= 0; i--) {
+		int bestParam = -1;
+		for (unsigned int j = 0; j < params.size(); j++)
+			if (!found[j] && insertPos[j] >= 0 && (bestParam < 0 || insertPos[j] > insertPos[bestParam]))
+				bestParam = j;
+		if (bestParam < 0)
+			break;
+		found[bestParam] = true;
+		outStr.Insert( (params[bestParam].param + " " + params[bestParam].paramValue + "\n").c_str(), insertPos[bestParam] );
 	}
+
+	prjStr->Set( outStr.Get(), outStr.GetLength() );
 }
 
-void SetProjectParameter(WDL_FastString *prjStr, string param, string paramValue){
-	SetProjectParameter(prjStr, param, paramValue, "");
+void AddProjectParameter( vector<ProjectParameter> &params, string param, string paramValue, string insertAfterParam = "" ){
+	ProjectParameter p;
+	p.param = param;
+	p.paramValue = paramValue;
+	p.insertAfterParam = insertAfterParam;
+	params.push_back(p);
 }
 
 string GetProjectParameterValueStr( WDL_FastString *prjStr, string param, int token = 1 ){
@@ -415,9 +434,15 @@ void NukeDirFiles( string dir, string ext = "" ){
 	closedir( dp );
 }
 
-void GetRenderedFiles(string dir, vector<RenderRegion> regions, map <string, RenderRegion> &files){
+void GetRenderedFiles(string dir, vector<RenderRegion> &regions, map <string, RenderRegion> &files){
 	DIR *dp;
 	struct dirent *dirp;
+
+	vector<string> regionFileNamePrefixes;
+	regionFileNamePrefixes.reserve(regions.size());
+	for (std::vector<RenderRegion>::iterator region = regions.begin(); region != regions.end(); ++region)
+		regionFileNamePrefixes.push_back(region->getFileName("", 2));
+
 	if ((dp = opendir(dir.c_str())) != NULL){
 		while ((dirp = readdir(dp)) != NULL){
 			string fileName = string(dirp->d_name);
@@ -426,12 +451,12 @@ void GetRenderedFiles(string dir, vector<RenderRegion> regions, map <string, Ren
 				continue;
 			}
 
-			for (std::vector<RenderRegion>::iterator region = regions.begin(); region != regions.end(); ++region) {
-				string regionFileNamePrefix = region->getFileName("", 2);
+			for (unsigned int i = 0; i < regions.size(); i++) {
+				const string &regionFileNamePrefix = regionFileNamePrefixes[i];
 				//TODO make sure filename sanitizing works as expected (REAPER internally handling during region rendering
 				if (!fileName.compare(0, regionFileNamePrefix.length(), regionFileNamePrefix)) {
 					string path = string(dir + PATH_SLASH_CHAR + fileName);
-					files.insert(pair <string, RenderRegion>(path, *region));
+					files.insert(pair <string, RenderRegion>(path, regions[i]));
 					break;
 				}
 			}
@@ -440,6 +465,31 @@ void GetRenderedFiles(string dir, vector<RenderRegion> regions, map <string, Ren
 	closedir(dp);
 }
 
+// Tagging is file I/O bound: files are tagged by SNM's worker threads, each file
+// being opened/saved once
+void TagRenderedFiles( const map<string, RenderRegion> &files ){
+	WDL_PtrList_DOD<SNM_MediaFileTags> tags;
+	for( map<string, RenderRegion>::const_iterator it = files.begin(); it != files.end(); ++it ){
+		SNM_MediaFileTags *t = tags.Add( new SNM_MediaFileTags( it->first.c_str() ) );
+		t->m_tags[SNM_TAG_ARTIST].Set( g_tag_artist.c_str() );
+		t->m_tags[SNM_TAG_ALBUM].Set( g_tag_album.c_str() );
+		t->m_tags[SNM_TAG_GENRE].Set( g_tag_genre.c_str() );
+		t->m_tags[SNM_TAG_COMMENT].Set( g_tag_comment.c_str() );
+		t->m_tags[SNM_TAG_TITLE].Set( it->second.regionName.c_str() );
+		if( g_tag_year > 0 ) t->m_tags[SNM_TAG_YEAR].SetFormatted( 32, "%d", g_tag_year );
+		if( it->second.regionNumber > 0 ) t->m_tags[SNM_TAG_TRACK].SetFormatted( 32, "%d", it->second.regionNumber );
+
+		// empty fields are left untouched, except title/track which are always set
+		t->m_setMask = (1<<SNM_TAG_TITLE) | (1<<SNM_TAG_TRACK);
+		if( !g_tag_artist.empty() ) t->m_setMask |= 1<<SNM_TAG_ARTIST;
+		if( !g_tag_album.empty() ) t->m_setMask |= 1<<SNM_TAG_ALBUM;
+		if( !g_tag_genre.empty() ) t->m_setMask |= 1<<SNM_TAG_GENRE;
+		if( !g_tag_comment.empty() ) t->m_setMask |= 1<<SNM_TAG_COMMENT;
+		if( g_tag_year > 0 ) t->m_setMask |= 1<<SNM_TAG_YEAR;
+	}
+	SNM_WriteMediaFilesTags( &tags );
+}
+
 void MakePathAbsolute( char* path, char* basePath ){
 #ifdef _WIN32
 	if (PathIsRelative(path))
@@ -455,7 +505,8 @@ void MakePathAbsolute( char* path, char* basePath ){
 
 void MakeMediaFilesAbsolute( WDL_FastString *prjStr ){
 	char line[4096];
-	int pos = 0;
+	int pos = 0, lineStart = 0;
+	WDL_FastString outStr; // rewritten in a single pass rather than patching prjStr line by line
 
 	LineParser lp(false);
 	bool inTrack = false;
@@ -475,6 +526,7 @@ void MakeMediaFilesAbsolute( WDL_FastString *prjStr ){
 
 	while( GetChunkLine( prjStr->Get(), line, 4096, &pos, false ) ){
 		lineNum++;
+		bool replaced = false;
 		if( !lp.parse( line ) && lp.getnumtokens() ) {
 			firstTokenStr = lp.gettoken_str(0);
 			firstTokenStr = firstTokenStr.substr(0,1);
@@ -514,7 +566,8 @@ void MakeMediaFilesAbsolute( WDL_FastString *prjStr ){
 						replacementStr.append( lp.gettoken_str( 2 ) );
 					}
 					replacementStr.append( string( "\n" ) );
-					WDLStringReplaceLine( prjStr, pos, line, replacementStr.c_str() );
+					outStr.Append( replacementStr.c_str() );
+					replaced = true;
 				} else if ( strcmp( firstChar, "<" ) == 0 ){
 					++trackItemSourceIgnoreChunks;
 				}
@@ -534,7 +587,11 @@ void MakeMediaFilesAbsolute( WDL_FastString *prjStr ){
 				inTrack = true;
 			}
 		}
+		if( !replaced )
+			outStr.Append( prjStr->Get() + lineStart, pos - lineStart );
+		lineStart = pos;
 	}
+	prjStr->Set( outStr.Get(), outStr.GetLength() );
 }
 
 
@@ -652,26 +709,28 @@ void AutorenderRegions(COMMAND_T*)
 	string outRenderProjectPath = outRenderProjectPrefix;
 	outRenderProjectPath += GetRenderQueueTimeString() + "_" + ARGetProjectName() + "_autorender.rpp";
 
+	vector<ProjectParameter> renderParams;
 	if (renderRegions.size() == 1 && renderRegions[0].entireProject) {
 		string regionFilename = renderRegions[0].getFileName("", 2);
 		if (g_render_path.empty()){
-			SetProjectParameter(&prjStr, "RENDER_FILE", "\"" + regionFilename + "\"");
+			AddProjectParameter(renderParams, "RENDER_FILE", "\"" + regionFilename + "\"");
 		} else {
-			SetProjectParameter(&prjStr, "RENDER_FILE", "\"" + g_render_path + PATH_SLASH_CHAR + regionFilename + "\"");
+			AddProjectParameter(renderParams, "RENDER_FILE", "\"" + g_render_path + PATH_SLASH_CHAR + regionFilename + "\"");
 		}
 
-		SetProjectParameter(&prjStr, "RENDER_RANGE", "1 0 0 18 1000");
+		AddProjectParameter(renderParams, "RENDER_RANGE", "1 0 0 18 1000");
 	} else {
 		if (!g_render_path.empty()){
-			SetProjectParameter(&prjStr, "RENDER_FILE", "\"" + g_render_path + "\"");
+			AddProjectParameter(renderParams, "RENDER_FILE", "\"" + g_render_path + "\"");
 		}
 
-		SetProjectParameter(&prjStr, "RENDER_PATTERN", "\"$timelineorder $region\"", "RENDER_FILE");
-		SetProjectParameter(&prjStr, "RENDER_RANGE", "3 0 0 18 1000");
+		AddProjectParameter(renderParams, "RENDER_PATTERN", "\"$timelineorder $region\"", "RENDER_FILE");
+		AddProjectParameter(renderParams, "RENDER_RANGE", "3 0 0 18 1000");
 	}
 
-	SetProjectParameter(&prjStr, "RENDER_STEMS", "0");
-	SetProjectParameter(&prjStr, "RENDER_ADDTOPROJ", "0");
+	AddProjectParameter(renderParams, "RENDER_STEMS", "0");
+	AddProjectParameter(renderParams, "RENDER_ADDTOPROJ", "0");
+	SetProjectParameters(&prjStr, renderParams);
 
 	WriteProjectFile(outRenderProjectPath, &prjStr);
 
@@ -681,31 +740,7 @@ void AutorenderRegions(COMMAND_T*)
 	GetRenderedFiles(g_render_path, renderRegions, renderedFiles);
 
 	// Tag!
-	for (std::map<string, RenderRegion>::iterator renderedFile = renderedFiles.begin(); renderedFile != renderedFiles.end(); ++renderedFile){
-		string renderedFilePath = renderedFile->first;
-		RenderRegion renderRegion = renderedFile->second;
-
-		TagLib::FileRef f( win32::widen(renderedFilePath).c_str() );
-
-		if( !f.isNull() ) {
-			if( !g_tag_artist.empty() )
-			  f.tag()->setArtist( {g_tag_artist, TagLib::String::UTF8} );
-			if( !g_tag_album.empty() )
-			  f.tag()->setAlbum( {g_tag_album, TagLib::String::UTF8} );
-			if( !g_tag_genre.empty() )
-			  f.tag()->setGenre( {g_tag_genre, TagLib::String::UTF8} );
-			if( !g_tag_comment.empty() )
-			  f.tag()->setComment( {g_tag_comment, TagLib::String::UTF8} );
-			f.tag()->setTitle( {renderRegion.regionName, TagLib::String::UTF8} );
-
-			if( g_tag_year > 0 ) f.tag()->setYear( g_tag_year );
-
-			f.tag()->setTrack( renderRegion.regionNumber );
-			f.save();
-		} else {
-			//throw error?
-		}
-	}
+	TagRenderedFiles(renderedFiles);
 
 	OpenRenderPath( NULL );
 	g_doing_render = false;
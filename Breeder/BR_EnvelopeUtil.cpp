@@ -44,6 +44,7 @@ m_sorted        (true),
 m_pointsEdited  (false),
 m_takeEnvOffset (0),
 m_sampleRate    (-1),
+m_committedValid (false),
 m_rebuildConseq (true),
 m_height        (-1),
 m_yOffset       (-1),
@@ -62,6 +63,7 @@ m_sorted        (true),
 m_pointsEdited  (false),
 m_takeEnvOffset (0),
 m_sampleRate    (-1),
+m_committedValid (false),
 m_rebuildConseq (true),
 m_height        (-1),
 m_yOffset       (-1),
@@ -83,6 +85,7 @@ m_sorted        (true),
 m_pointsEdited  (false),
 m_takeEnvOffset (0),
 m_sampleRate    (-1),
+m_committedValid (false),
 m_rebuildConseq (true),
 m_height        (-1),
 m_yOffset       (-1),
@@ -102,6 +105,7 @@ m_sorted        (true),
 m_pointsEdited  (false),
 m_takeEnvOffset (0),
 m_sampleRate    (-1),
+m_committedValid (false),
 m_rebuildConseq (true),
 m_height        (-1),
 m_yOffset       (-1),
@@ -127,6 +131,10 @@ m_yOffset         (envelope.m_yOffset),
 m_takeEnvType     (envelope.m_takeEnvType),
 m_data            (envelope.m_data),
 m_points          (envelope.m_points),
+m_pointsCommitted (envelope.m_pointsCommitted),
+m_committedValid  (envelope.m_committedValid),
+m_tempoChunk      (envelope.m_tempoChunk),
+m_tempoLines      (envelope.m_tempoLines),
 m_pointsSel       (envelope.m_pointsSel),
 m_pointsConseq    (envelope.m_pointsConseq),
 m_properties      (envelope.m_properties),
@@ -159,12 +167,16 @@ BR_Envelope& BR_Envelope::operator= (const BR_Envelope& envelope)
 	m_takeEnvType   = envelope.m_takeEnvType;
 	m_data          = envelope.m_data;
 	m_points        = envelope.m_points;
+	m_pointsCommitted = envelope.m_pointsCommitted;
+	m_committedValid  = envelope.m_committedValid;
+	m_tempoLines      = envelope.m_tempoLines;
 	m_pointsSel     = envelope.m_pointsSel;
 	m_pointsConseq  = envelope.m_pointsConseq;
 	m_properties    = envelope.m_properties;
 
 	m_chunkProperties.Set(&envelope.m_chunkProperties);
 	m_envName.Set(&envelope.m_envName);
+	m_tempoChunk.Set(&envelope.m_tempoChunk);
 
 	return *this;
 }
@@ -1450,68 +1462,21 @@ bool BR_Envelope::Commit (bool force /*=false*/)
 		// Need to commit whole chunk
 		if (m_tempoMap)
 		{
-			WDL_FastString chunkStart = this->GetProperties();
-			for (vector<BR_Envelope::EnvPoint>::iterator i = m_points.begin(); i != m_points.end(); ++i)
-				i->Append(chunkStart, true);
-			chunkStart.Append(">");
-			GetSetObjectState(m_envelope, chunkStart.Get());
-			UpdateTempoTimeline();
+			this->CommitTempoMap();
 		}
 		// We can update through API (faster)
 		else
 		{
 			PreventUIRefresh(1);
 
-			// If properties were changed, first commit chunk with properties only and one point (one point prevents REAPER
-			// from removing envelope completely) (creating points later using API instead of supplying full chunk is faster)
-			bool firstPointDone = false;
-			if (m_properties.changed || force)
-			{
-				WDL_FastString chunkStart = this->GetProperties();
-				if (!m_points.empty())
-				{
-					m_points[0].Append(chunkStart, false);
-					firstPointDone = true;
-				}
-				chunkStart.Append(">");
-				GetSetObjectState(m_envelope, chunkStart.Get());
-			}
-
-			// Delete excess points
-			size_t currentCount = CountEnvelopePoints(m_envelope);
-			if (currentCount > m_points.size())
-			{
-				double startTime, endTime;
-				if (m_points.size() > 0) GetEnvelopePoint(m_envelope, m_points.size() - 1, &startTime, NULL, NULL, NULL, NULL);
-				else                  startTime = 0;
-				if (currentCount    > 0) GetEnvelopePoint(m_envelope, currentCount - 1, &endTime,   NULL, NULL, NULL, NULL);
-				else                  endTime = 0;
-
-				startTime -= 1;
-				endTime   += 1;
-				DeleteEnvelopePointRange(m_envelope, startTime, endTime);
-			}
-
-			// Edit/insert cached points
-			currentCount = CountEnvelopePoints(m_envelope);
 			const double playrate = m_take ? GetMediaItemTakeInfo_Value(m_take, "D_PLAYRATE") : 1;
-			for (size_t i = firstPointDone; i < currentCount; ++i)
-			{
-				double value = (m_properties.faderMode != 0) ? ScaleToEnvelopeMode(m_properties.faderMode, m_points[i].value) : m_points[i].value;
-				double position = m_points[i].position * playrate;
-				SetEnvelopePoint(m_envelope, i, &position, &value, &m_points[i].shape, &m_points[i].bezier, &m_points[i].selected, &g_bTrue);
-			}
-			for (size_t i = currentCount; i < m_points.size(); ++i)
-			{
-				double value = (m_properties.faderMode != 0) ? ScaleToEnvelopeMode(m_properties.faderMode, m_points[i].value) : m_points[i].value;
-				double position = m_points[i].position * playrate;
-				InsertEnvelopePoint(m_envelope, position, value, m_points[i].shape, m_points[i].bezier, m_points[i].selected, &g_bTrue);
-			}
-			Envelope_SortPoints(m_envelope);
+			if (m_properties.changed || force || !this->CommitEditedPoints(playrate))
+				this->CommitAllPoints(playrate, force);
 
 			PreventUIRefresh(-1);
 		}
 
+		this->UpdateCommitted();
 		UpdateArrange();
 		m_update       = false;
 		m_pointsEdited = false;
@@ -1654,28 +1619,45 @@ void BR_Envelope::Build (bool takeEnvelopesUseProjectTime)
 		// Since information on partial measures is missing from the API, we need to parse the chunk for tempo map
 		if (m_tempoMap)
 		{
-			char* envState = GetSetObjectState(m_envelope, "");
-			char* token = strtok(envState, "\n");
-			LineParser lp(false);
-			bool start = false;
-			int id = -1;
-			while (token != NULL)
+			std::string* envState = NULL;
+			try
 			{
-				lp.parse(token);
-				BR_Envelope::EnvPoint point;
-				if (point.ReadLine(lp))
+				envState = &envelope::GetEnvelopeStateChunkBuffer(m_envelope);
+			}
+			catch (const envelope::bad_get_env_chunk_big&)
+			{
+			}
+
+			if (envState)
+			{
+				m_tempoChunk.Set(envState->c_str(), (int)envState->size());
+				m_tempoLines.reserve(count);
+
+				envelope::LineIterator lines(*envState);
+				char* token = lines.next();
+				LineParser lp(false);
+				bool start = false;
+				int id = -1;
+				while (token != NULL)
 				{
-					++id;
-					start = true;
-					m_points.push_back(point);
-					if (point.selected == 1)
-						m_pointsSel.push_back(id);
+					lp.parse(token);
+					BR_Envelope::EnvPoint point;
+					if (point.ReadLine(lp))
+					{
+						++id;
+						start = true;
+						m_points.push_back(point);
+						if (point.selected == 1)
+							m_pointsSel.push_back(id);
+
+						BR_Envelope::IdPair line = {(int)(token - envState->c_str()), (int)strlen(token)};
+						m_tempoLines.push_back(line);
+					}
+					else if (!start)
+						AppendLine(m_chunkProperties, token);
+					token = lines.next();
 				}
-				else if (!start)
-					AppendLine(m_chunkProperties, token);
-				token = strtok(NULL, "\n");
 			}
-			FreeHeapPtr(envState);
 		}
 		else
 		{
@@ -1693,12 +1675,198 @@ void BR_Envelope::Build (bool takeEnvelopesUseProjectTime)
 				if (point.selected) m_pointsSel.push_back(i);
 			}
 		}
+
+		this->UpdateCommitted();
 	}
 
 	if (takeEnvelopesUseProjectTime && m_take)
 		m_takeEnvOffset = GetMediaItemInfo_Value(GetMediaItemTake_Item(m_take), "D_POSITION");
 }
 
+bool BR_Envelope::GetEditedRange (int* startId, int* oldEndId, int* newEndId)
+{
+	if (!m_committedValid)
+		return false;
+
+	// Points before startId and from oldEndId/newEndId onward are the same in both committed and current points
+	const int oldCount = (int)m_pointsCommitted.size();
+	const int newCount = (int)m_points.size();
+
+	int start = 0;
+	while (start < oldCount && start < newCount && m_points[start] == m_pointsCommitted[start])
+		++start;
+
+	int oldEnd = oldCount;
+	int newEnd = newCount;
+	while (oldEnd > start && newEnd > start && m_points[newEnd-1] == m_pointsCommitted[oldEnd-1])
+	{
+		--oldEnd;
+		--newEnd;
+	}
+
+	WritePtr(startId,  start);
+	WritePtr(oldEndId, oldEnd);
+	WritePtr(newEndId, newEnd);
+	return true;
+}
+
+bool BR_Envelope::CommitEditedPoints (double playrate)
+{
+	int startId, oldEndId, newEndId;
+	if (!this->GetEditedRange(&startId, &oldEndId, &newEndId))
+		return false;
+
+	// Envelope changed behind our back (or we're rewriting most of it anyway), so commit everything
+	const int editedCount = max(oldEndId, newEndId) - startId;
+	if (CountEnvelopePoints(m_envelope) != (int)m_pointsCommitted.size() || (editedCount > 1000 && editedCount > (int)m_points.size() / 2))
+		return false;
+
+	bool sort = false;
+	const int setEndId = min(oldEndId, newEndId);
+	for (int i = startId; i < setEndId; ++i)
+	{
+		if (m_points[i] == m_pointsCommitted[i])
+			continue;
+
+		double value = (m_properties.faderMode != 0) ? ScaleToEnvelopeMode(m_properties.faderMode, m_points[i].value) : m_points[i].value;
+		double position = m_points[i].position * playrate;
+		SetEnvelopePoint(m_envelope, i, &position, &value, &m_points[i].shape, &m_points[i].bezier, &m_points[i].selected, &g_bTrue);
+		if (m_points[i].position != m_pointsCommitted[i].position)
+			sort = true;
+	}
+
+	// New points get inserted, sorting will put them (and points after them) into right place
+	for (int i = setEndId; i < newEndId; ++i)
+	{
+		double value = (m_properties.faderMode != 0) ? ScaleToEnvelopeMode(m_properties.faderMode, m_points[i].value) : m_points[i].value;
+		double position = m_points[i].position * playrate;
+		InsertEnvelopePoint(m_envelope, position, value, m_points[i].shape, m_points[i].bezier, m_points[i].selected, &g_bTrue);
+		sort = true;
+	}
+
+	// There is no API for deleting point by id, so move excess points past the last point and delete them by range
+	double excessPosition = 0;
+	if (setEndId < oldEndId)
+	{
+		for (size_t i = 0; i < m_points.size(); ++i)
+			excessPosition = max(excessPosition, m_points[i].position * playrate);
+		excessPosition += 10;
+
+		for (int i = setEndId; i < oldEndId; ++i)
+			SetEnvelopePoint(m_envelope, i, &excessPosition, NULL, NULL, NULL, NULL, &g_bTrue);
+		sort = true;
+	}
+
+	if (sort)
+		Envelope_SortPoints(m_envelope);
+	if (setEndId < oldEndId)
+		DeleteEnvelopePointRange(m_envelope, excessPosition - 1, excessPosition + 1);
+
+	return true;
+}
+
+void BR_Envelope::CommitAllPoints (double playrate, bool force)
+{
+	// If properties were changed, first commit chunk with properties only and one point (one point prevents REAPER
+	// from removing envelope completely) (creating points later using API instead of supplying full chunk is faster)
+	bool firstPointDone = false;
+	if (m_properties.changed || force)
+	{
+		WDL_FastString chunkStart = this->GetProperties();
+		if (!m_points.empty())
+		{
+			m_points[0].Append(chunkStart, false);
+			firstPointDone = true;
+		}
+		chunkStart.Append(">");
+		GetSetObjectState(m_envelope, chunkStart.Get());
+	}
+
+	// Delete excess points
+	size_t currentCount = CountEnvelopePoints(m_envelope);
+	if (currentCount > m_points.size())
+	{
+		double startTime, endTime;
+		if (m_points.size() > 0) GetEnvelopePoint(m_envelope, m_points.size() - 1, &startTime, NULL, NULL, NULL, NULL);
+		else                  startTime = 0;
+		if (currentCount    > 0) GetEnvelopePoint(m_envelope, currentCount - 1, &endTime,   NULL, NULL, NULL, NULL);
+		else                  endTime = 0;
+
+		startTime -= 1;
+		endTime   += 1;
+		DeleteEnvelopePointRange(m_envelope, startTime, endTime);
+	}
+
+	// Edit/insert cached points
+	currentCount = CountEnvelopePoints(m_envelope);
+	for (size_t i = firstPointDone; i < currentCount; ++i)
+	{
+		double value = (m_properties.faderMode != 0) ? ScaleToEnvelopeMode(m_properties.faderMode, m_points[i].value) : m_points[i].value;
+		double position = m_points[i].position * playrate;
+		SetEnvelopePoint(m_envelope, i, &position, &value, &m_points[i].shape, &m_points[i].bezier, &m_points[i].selected, &g_bTrue);
+	}
+	for (size_t i = currentCount; i < m_points.size(); ++i)
+	{
+		double value = (m_properties.faderMode != 0) ? ScaleToEnvelopeMode(m_properties.faderMode, m_points[i].value) : m_points[i].value;
+		double position = m_points[i].position * playrate;
+		InsertEnvelopePoint(m_envelope, position, value, m_points[i].shape, m_points[i].bezier, m_points[i].selected, &g_bTrue);
+	}
+	Envelope_SortPoints(m_envelope);
+}
+
+void BR_Envelope::CommitTempoMap ()
+{
+	// Lines of unedited points are copied from the last committed chunk instead of being formatted again
+	int startId = 0, oldEndId = 0, newEndId = 0;
+	const bool copyLines = this->GetEditedRange(&startId, &oldEndId, &newEndId) && m_tempoLines.size() == m_pointsCommitted.size();
+	if (copyLines && startId == oldEndId && startId == newEndId && !m_properties.changed)
+		return;
+
+	WDL_FastString chunk = this->GetProperties();
+	vector<BR_Envelope::IdPair> lines;
+	lines.reserve(m_points.size());
+
+	for (int i = 0; i < (int)m_points.size(); ++i)
+	{
+		int committedId = -1;
+		if (copyLines)
+		{
+			if      (i < startId)   committedId = i;
+			else if (i >= newEndId) committedId = i - newEndId + oldEndId;
+		}
+
+		BR_Envelope::IdPair line = {chunk.GetLength(), 0};
+		if (committedId >= 0)
+		{
+			chunk.Append(m_tempoChunk.Get() + m_tempoLines[committedId].first, m_tempoLines[committedId].second);
+			chunk.Append("\n");
+		}
+		else
+		{
+			m_points[i].Append(chunk, true);
+		}
+		line.second = chunk.GetLength() - line.first - 1;
+		lines.push_back(line);
+	}
+	chunk.Append(">");
+
+	GetSetObjectState(m_envelope, chunk.Get());
+	UpdateTempoTimeline();
+
+	m_tempoChunk.Set(&chunk);
+	m_tempoLines.swap(lines);
+}
+
+void BR_Envelope::UpdateCommitted ()
+{
+	// REAPER sorts points on commit so if ours aren't sorted, ids won't match anymore
+	m_committedValid = m_sorted;
+	if (m_committedValid)
+		m_pointsCommitted = m_points;
+	else
+		m_pointsCommitted.clear();
+}
+
 void BR_Envelope::UpdateConsequential ()
 {
 	for (size_t i = 0; i < m_pointsSel.size(); ++i)
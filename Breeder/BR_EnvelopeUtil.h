@@ -237,6 +237,11 @@ private:
 	int FindNext (double position, double offset);     // used for internal stuff since position
 	int FindPrevious (double position, double offset); // offset of take envelopes has to be tracked
 	void Build (bool takeEnvelopesUseProjectTime);
+	bool GetEditedRange (int* startId, int* oldEndId, int* newEndId); // compares points with m_pointsCommitted, returns false if committed state is unknown
+	bool CommitEditedPoints (double playrate);                         // returns false if points need to be committed with CommitAllPoints()
+	void CommitAllPoints (double playrate, bool force);
+	void CommitTempoMap ();
+	void UpdateCommitted ();
 	void UpdateConsequential ();
 	void FillFxInfo ();
 	bool FillProperties () const; // to make operator== const (yes, m_properties does get modified but only if not cached already)
@@ -256,6 +261,10 @@ private:
 	BR_EnvType m_takeEnvType;
 	void* m_data;
 	vector<BR_Envelope::EnvPoint> m_points;
+	vector<BR_Envelope::EnvPoint> m_pointsCommitted; // points as they currently are in REAPER, used to commit only edited points
+	bool m_committedValid;                          // false if m_pointsCommitted doesn't match REAPER's point order (i.e. REAPER had to sort points on last commit)
+	WDL_FastString m_tempoChunk;                    // tempo map chunk as last read/committed, unchanged point lines are copied from here
+	vector<IdPair> m_tempoLines;                    // offset and length of each committed point's line in m_tempoChunk
 	bool m_rebuildConseq;
 	vector<size_t> m_pointsSel;
 	vector<IdPair> m_pointsConseq;
@@ -79,6 +79,7 @@ static const char cLayoutTypes[][256] = { "(hide)" }; // #1008, additional '(hid
 SWS_AutoColorWnd* g_pACWnd = NULL;
 static WDL_PtrList<SWS_RuleItem> g_pACItems;
 static SWSProjConfig<WDL_PtrList<SWS_RuleTrack> > g_pACTracks;
+static SWSProjConfig<WDL_FastString> g_ACRulesState; // rules/options used for the last AutoColorTrack()
 static bool g_bACEnabled = false;
 static bool g_bACREnabled = false;
 static bool g_bACMEnabled = false;
@@ -704,7 +705,33 @@ void OpenAutoColor(COMMAND_T*)
 	g_pACWnd->Show(true, true);
 }
 
-void ApplyColorRuleToTrack(SWS_RuleItem* rule, bool bDoColors, bool bDoIcons, bool bDoLayout, bool bForce)
+// Compiled track rule: the special filter type, or -1 for a track name filter
+struct ACTrackRule
+{
+	int filter;
+	WDL_String lcPattern;
+};
+
+static bool MatchTrackRule(ACTrackRule* r, SWS_RuleTrack* t)
+{
+	if (!t->m_iIndex) // ignore master for most things
+		return r->filter == AC_MASTER;
+
+	switch (r->filter)
+	{
+		case AC_ANY:        return true;
+		case AC_UNNAMED:    return !t->m_lcName.GetLength();
+		case AC_FOLDER:     return t->m_iFolderType == 1;
+		case AC_CHILDREN:   return t->m_iDepth >= 1;
+		case AC_RECEIVE:    return t->m_bReceive;
+		case AC_REC_ARM:    return t->m_bRecArm;
+		case AC_VCA_MASTER: return t->m_bVcaMaster;
+		default:            return strstr(t->m_lcName.Get(), r->lcPattern.Get()) != NULL; // name match (incl. "(master)" for other tracks)
+	}
+}
+
+// tracks: g_pACTracks in track order (master first), with up to date m_matches
+void ApplyColorRuleToTrack(SWS_RuleItem* rule, int iRule, WDL_PtrList<SWS_RuleTrack>* tracks, bool bDoColors, bool bDoIcons, bool bDoLayout, bool bForce)
 {
 	if(rule->m_type == AC_TRACK)
 	{
@@ -714,112 +741,36 @@ void ApplyColorRuleToTrack(SWS_RuleItem* rule, bool bDoColors, bool bDoIcons, bo
 		PreventUIRefresh(1);
 
 		int iCount = 0;
-		WDL_PtrList<void> gradientTracks;
+		WDL_PtrList<SWS_RuleTrack> gradientTracks;
 
 		if (rule->m_color == -AC_CUSTOM-1)
 			UpdateCustomColors();
 
 		// Check all tracks for matching strings/properties
-		MediaTrack* temp = NULL;
-		for (int i = 0; i <= GetNumTracks(); i++)
+		for (int i = 0; i < tracks->GetSize(); i++)
 		{
-			MediaTrack* tr = CSurf_TrackFromID(i, false);
+			SWS_RuleTrack* pACTrack = tracks->Get(i);
+			MediaTrack* tr = pACTrack->m_pTr;
 			bool bColor = bDoColors;
 			bool bIcon  = bDoIcons;
 			bool bLayout[2];
 			bLayout[0]=bLayout[1]=bDoLayout;
 
-			bool bFound = false;
-			SWS_RuleTrack* pACTrack = NULL;
-			for (int j = 0; j < g_pACTracks.Get()->GetSize(); j++)
-			{
-				pACTrack = g_pACTracks.Get()->Get(j);
-				if (pACTrack->m_pTr == tr)
-				{
-					bFound = true;
-					break;
-				}
-			}
-
-			if (bFound)
-			{
-				// If already modified by a different rule, or ignoring the color/icon/layout ignore this track
-				if (pACTrack->m_bColored || rule->m_color == -AC_IGNORE-1)
-					bColor = false;
+			// If already modified by a different rule, or ignoring the color/icon/layout ignore this track
+			if (pACTrack->m_bColored || rule->m_color == -AC_IGNORE-1)
+				bColor = false;
 
-				if (pACTrack->m_bIconed || !rule->m_icon.Get()[0])
-					bIcon = false;
+			if (pACTrack->m_bIconed || !rule->m_icon.Get()[0])
+				bIcon = false;
 
-				for (int k=0; k<2; k++)
-					if (pACTrack->m_bLayouted[k] || !rule->m_layout[k].Get()[0])
-						bLayout[k] = false;
-			}
-			else
-				pACTrack = g_pACTracks.Get()->Add(new SWS_RuleTrack(tr));
+			for (int k=0; k<2; k++)
+				if (pACTrack->m_bLayouted[k] || !rule->m_layout[k].Get()[0])
+					bLayout[k] = false;
 
 			// Do the track rule matching
 			if (bColor || bIcon || bLayout[0] || bLayout[1])
 			{
-				bool bMatch = false;
-
-				if (i) // ignore master for most things
-				{
-					// Check "special" rules first:
-					if (strcmp(rule->m_str_filter.Get(), cFilterTypes[AC_FOLDER]) == 0)
-					{
-						int iType;
-						GetFolderDepth(tr, &iType, &temp);
-						if (iType == 1)
-							bMatch = true;
-					}
-					else if (strcmp(rule->m_str_filter.Get(), cFilterTypes[AC_CHILDREN]) == 0)
-					{
-						temp = CSurf_TrackFromID(0, false); // JFB fix: 'temp' could be out of sync
-						if (GetFolderDepth(tr, NULL, &temp) >= 1)
-							bMatch = true;
-					}
-					else if (strcmp(rule->m_str_filter.Get(), cFilterTypes[AC_RECEIVE]) == 0)
-					{
-						if (GetSetTrackSendInfo(tr, -1, 0, "P_SRCTRACK", NULL))
-							bMatch = true;
-					}
-					else if (strcmp(rule->m_str_filter.Get(), cFilterTypes[AC_UNNAMED]) == 0)
-					{
-						char* cName = (char*)GetSetMediaTrackInfo(tr, "P_NAME", NULL);
-						if (!cName || !cName[0])
-							bMatch = true;
-					}
-					else if (strcmp(rule->m_str_filter.Get(), cFilterTypes[AC_REC_ARM]) == 0)
-					{
-						int* ra = (int*)GetSetMediaTrackInfo(tr, "I_RECARM", NULL);
-						if (ra && *ra)
-							bMatch = true;
-					}
-					else if (strcmp(rule->m_str_filter.Get(), cFilterTypes[AC_VCA_MASTER]) == 0)
-					{
-						int iVcaMaster = GetSetTrackGroupMembership(tr, "VOLUME_VCA_MASTER", 0, 0);
-
-						// check newly added groups 33 - 64
-						int iVcaMasterHigh = GetSetTrackGroupMembershipHigh(tr, "VOLUME_VCA_MASTER", 0, 0);
-
-						if (iVcaMaster || iVcaMasterHigh)
-							bMatch = true;
-					}
-					else if (strcmp(rule->m_str_filter.Get(), cFilterTypes[AC_ANY]) == 0)
-					{
-						bMatch = true;
-					}
-					else // Check for name match
-					{
-						char* cName = (char*)GetSetMediaTrackInfo(tr, "P_NAME", NULL);
-						if (cName && stristr(cName, rule->m_str_filter.Get()))
-							bMatch = true;
-					}
-				}
-				else if (strcmp(rule->m_str_filter.Get(), cFilterTypes[AC_MASTER]) == 0)
-				{	// Check master rule
-					bMatch = true;
-				}
+				bool bMatch = iRule < pACTrack->m_matches.GetSize() && pACTrack->m_matches.Get()[iRule];
 
 				if (bMatch)
 				{
@@ -844,7 +795,7 @@ void ApplyColorRuleToTrack(SWS_RuleItem* rule, bool bDoColors, bool bDoIcons, bo
 							newCol |= 0x1000000;
 						}
 						else if (rule->m_color == -AC_GRADIENT-1)
-							gradientTracks.Add(tr);
+							gradientTracks.Add(pACTrack);
 						else if (rule->m_color == -AC_NONE-1)
 							newCol = 0;
 						else if (rule->m_color == -AC_PARENT-1)
@@ -934,13 +885,8 @@ void ApplyColorRuleToTrack(SWS_RuleItem* rule, bool bDoColors, bool bDoIcons, bo
 			int newCol = g_crGradStart | 0x1000000;
 			if (i && gradientTracks.GetSize() > 1)
 				newCol = CalcGradient(g_crGradStart, g_crGradEnd, (double)i / (gradientTracks.GetSize()-1)) | 0x1000000;
-			for (int j = 0; j < g_pACTracks.Get()->GetSize(); j++)
-				if (g_pACTracks.Get()->Get(j)->m_pTr == (MediaTrack*)gradientTracks.Get(i))
-				{
-					g_pACTracks.Get()->Get(j)->m_col = newCol;
-					break;
-				}
-			GetSetMediaTrackInfo((MediaTrack*)gradientTracks.Get(i), "I_CUSTOMCOLOR", &newCol);
+			gradientTracks.Get(i)->m_col = newCol;
+			GetSetMediaTrackInfo(gradientTracks.Get(i)->m_pTr, "I_CUSTOMCOLOR", &newCol);
 		}
 
 		PreventUIRefresh(-1);
@@ -958,14 +904,153 @@ void AutoColorTrack(bool bForce)
 	// If forcing, start over with the saved track list
 	if (bForce)
 		g_pACTracks.Get()->Empty(true);
-	else
-		// Remove non-existant tracks from the autocolortracklist
-		for (int i = 0; i < g_pACTracks.Get()->GetSize(); i++)
-			if (CSurf_TrackToID(g_pACTracks.Get()->Get(i)->m_pTr, false) < 0)
+
+	bool bDoColors = g_bACEnabled || bForce;
+	bool bDoIcons  = g_bAIEnabled || bForce;
+	bool bDoLayouts  = g_bALEnabled || bForce;
+
+	// Compile the track rules, and only read the track properties they depend on
+	WDL_PtrList_DOD<ACTrackRule> rules;
+	bool bNeedName = false, bNeedFolder = false, bNeedReceive = false, bNeedRecArm = false, bNeedVca = false, bNeedParentCol = false;
+	WDL_FastString rulesState;
+	rulesState.SetFormatted(128, "%d %d %d %d %d ", bDoColors, bDoIcons, bDoLayouts, (int)g_crGradStart, (int)g_crGradEnd);
+	for (int i = 0; i < g_pACItems.GetSize(); i++)
+	{
+		SWS_RuleItem* rule = g_pACItems.Get(i);
+		ACTrackRule* r = rules.Add(new ACTrackRule);
+		r->filter = -1;
+		if (rule->m_type != AC_TRACK)
+			continue;
+
+		for (int j = 0; j < NUM_FILTERTYPES; j++)
+			if (!strcmp(rule->m_str_filter.Get(), cFilterTypes[j]))
 			{
-				g_pACTracks.Get()->Delete(i, true);
-				i--;
+				r->filter = j;
+				break;
 			}
+		r->lcPattern.Set(rule->m_str_filter.Get());
+		for (int j = 0; j < r->lcPattern.GetLength(); j++)
+			r->lcPattern.Get()[j] = tolower(r->lcPattern.Get()[j]);
+
+		switch (r->filter)
+		{
+			case AC_FOLDER: case AC_CHILDREN: bNeedFolder = true; break;
+			case AC_RECEIVE: bNeedReceive = true; break;
+			case AC_REC_ARM: bNeedRecArm = true; break;
+			case AC_VCA_MASTER: bNeedVca = true; break;
+			case AC_ANY: break;
+			default: bNeedName = true; break; // incl. AC_UNNAMED
+		}
+		if (rule->m_color == -AC_PARENT-1)
+			bNeedParentCol = true;
+		if (rule->m_color == -AC_CUSTOM-1)
+		{
+			UpdateCustomColors();
+			for (int j = 0; j < 16; j++)
+				rulesState.AppendFormatted(16, "%d ", (int)g_custColors[j]);
+		}
+		rulesState.AppendFormatted(4096, "\n%d %s %d %s %s %s", i, rule->m_str_filter.Get(), rule->m_color, rule->m_icon.Get(), rule->m_layout[0].Get(), rule->m_layout[1].Get());
+	}
+	const bool bRulesChanged = strcmp(rulesState.Get(), g_ACRulesState.Get()->Get()) != 0;
+	if (bRulesChanged)
+		g_ACRulesState.Get()->Set(rulesState.Get());
+
+	// Update the tracks' properties, re-match the rules only for tracks whose properties changed
+	WDL_PtrKeyedArray<SWS_RuleTrack*> acTracks;
+	for (int i = 0; i < g_pACTracks.Get()->GetSize(); i++)
+	{
+		SWS_RuleTrack* r = g_pACTracks.Get()->Get(i);
+		r->m_bSeen = false;
+		acTracks.AddUnsorted((INT_PTR)r->m_pTr, r);
+	}
+	acTracks.Resort();
+
+	bool bChanged = bForce || bRulesChanged;
+	WDL_PtrList<SWS_RuleTrack> tracks;
+	MediaTrack* nextTr = NULL;
+	for (int i = 0; i <= GetNumTracks(); i++)
+	{
+		MediaTrack* tr = CSurf_TrackFromID(i, false);
+		SWS_RuleTrack* r = acTracks.Get((INT_PTR)tr, NULL);
+		if (!r || r->m_bSeen)
+			r = g_pACTracks.Get()->Add(new SWS_RuleTrack(tr));
+		r->m_bSeen = true;
+		tracks.Add(r);
+
+		bool bInputsChanged = r->m_iIndex != i || r->m_matches.GetSize() != rules.GetSize();
+		if (bNeedName)
+		{
+			const char* cName = (const char*)GetSetMediaTrackInfo(tr, "P_NAME", NULL);
+			if (!cName) cName = "";
+			int j = 0;
+			while (cName[j] && tolower(cName[j]) == r->m_lcName.Get()[j]) j++;
+			if (cName[j] || j != r->m_lcName.GetLength())
+			{
+				r->m_lcName.Set(cName);
+				for (j = 0; j < r->m_lcName.GetLength(); j++)
+					r->m_lcName.Get()[j] = tolower(r->m_lcName.Get()[j]);
+				bInputsChanged = true;
+			}
+		}
+		if (bNeedFolder)
+		{
+			int iType = 0;
+			int iDepth = GetFolderDepth(tr, &iType, &nextTr);
+			if (iType != r->m_iFolderType || iDepth != r->m_iDepth)
+			{
+				r->m_iFolderType = iType;
+				r->m_iDepth = iDepth;
+				bInputsChanged = true;
+			}
+		}
+		if (bNeedReceive && i)
+		{
+			bool bReceive = GetSetTrackSendInfo(tr, -1, 0, "P_SRCTRACK", NULL) != NULL;
+			if (bReceive != r->m_bReceive) { r->m_bReceive = bReceive; bInputsChanged = true; }
+		}
+		if (bNeedRecArm && i)
+		{
+			int* ra = (int*)GetSetMediaTrackInfo(tr, "I_RECARM", NULL);
+			bool bRecArm = ra && *ra;
+			if (bRecArm != r->m_bRecArm) { r->m_bRecArm = bRecArm; bInputsChanged = true; }
+		}
+		if (bNeedVca && i)
+		{
+			// check newly added groups 33 - 64 too
+			bool bVca = GetSetTrackGroupMembership(tr, "VOLUME_VCA_MASTER", 0, 0) || GetSetTrackGroupMembershipHigh(tr, "VOLUME_VCA_MASTER", 0, 0);
+			if (bVca != r->m_bVcaMaster) { r->m_bVcaMaster = bVca; bInputsChanged = true; }
+		}
+		if (bNeedParentCol)
+		{
+			MediaTrack* parent = (MediaTrack*)GetSetMediaTrackInfo(tr, "P_PARTRACK", NULL);
+			int iParentCol = parent ? *(int*)GetSetMediaTrackInfo(parent, "I_CUSTOMCOLOR", NULL) : 0;
+			if (iParentCol != r->m_iParentCol) { r->m_iParentCol = iParentCol; bChanged = true; } // no re-matching needed
+		}
+
+		if (bInputsChanged || bRulesChanged)
+		{
+			r->m_iIndex = i;
+			char* matches = r->m_matches.Resize(rules.GetSize(), false);
+			for (int j = 0; j < rules.GetSize(); j++)
+				matches[j] = g_pACItems.Get(j)->m_type == AC_TRACK && MatchTrackRule(rules.Get(j), r);
+			bChanged = true;
+		}
+	}
+
+	// Remove non-existant tracks from the autocolortracklist
+	for (int i = 0; i < g_pACTracks.Get()->GetSize(); i++)
+		if (!g_pACTracks.Get()->Get(i)->m_bSeen)
+		{
+			g_pACTracks.Get()->Delete(i--, true);
+			bChanged = true;
+		}
+
+	// Nothing the rules depend on has changed, the tracks are up to date
+	if (!bChanged)
+	{
+		bRecurse = false;
+		return;
+	}
 
 	// Clear the "colored" bit and "iconed" bit
 	for (int i = 0; i < g_pACTracks.Get()->GetSize(); i++)
@@ -978,14 +1063,10 @@ void AutoColorTrack(bool bForce)
 	}
 
 	// Apply the rules
-	bool bDoColors = g_bACEnabled || bForce;
-	bool bDoIcons  = g_bAIEnabled || bForce;
-	bool bDoLayouts  = g_bALEnabled || bForce;
-
 	PreventUIRefresh(1);
 
 	for (int i = 0; i < g_pACItems.GetSize(); i++)
-		ApplyColorRuleToTrack(g_pACItems.Get(i), bDoColors, bDoIcons, bDoLayouts, bForce);
+		ApplyColorRuleToTrack(g_pACItems.Get(i), i, &tracks, bDoColors, bDoIcons, bDoLayouts, bForce);
 
 	// Remove colors/icons if necessary
 	for (int i = 0; i < g_pACTracks.Get()->GetSize(); i++)
@@ -49,7 +49,8 @@ class SWS_RuleTrack
 {
 public:
 	SWS_RuleTrack(MediaTrack* tr)
-		:m_pTr(tr),m_col(0),m_bColored(false),m_bIconed(false)
+		:m_pTr(tr),m_col(0),m_bColored(false),m_bIconed(false),
+		m_iIndex(-1),m_iFolderType(0),m_iDepth(0),m_iParentCol(0),m_bReceive(false),m_bRecArm(false),m_bVcaMaster(false),m_bSeen(false)
 	{
 		m_bLayouted[0]=m_bLayouted[1]=false;
 	}
@@ -58,6 +59,12 @@ public:
 	bool m_bColored, m_bIconed, m_bLayouted[2];
 	int m_col;
 	WDL_FastString m_icon, m_layout[2];
+
+	// Track properties the rules depend on, and the rule matches they lead to (see AutoColorTrack())
+	int m_iIndex, m_iFolderType, m_iDepth, m_iParentCol;
+	bool m_bReceive, m_bRecArm, m_bVcaMaster, m_bSeen;
+	WDL_String m_lcName;
+	WDL_TypedBuf<char> m_matches; // one per rule in the rule list
 };
 
 class SWS_AutoColorView : public SWS_ListView
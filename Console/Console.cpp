@@ -48,7 +48,7 @@ static DWORD g_dwLastKeyMsg = 0;
 bool g_bCloseOnReturnPref = false;
 
 CONSOLE_COMMAND Tokenize(char* strCommand, const char** trackid, const char** args);
-void ParseTrackId(char* strId, bool bReset = true);
+void ParseTrackId(const char* strId);
 void ProcessCommand(CONSOLE_COMMAND command, const char* args);
 const char* StatusString(CONSOLE_COMMAND command, const char* args);
 
@@ -186,194 +186,309 @@ CONSOLE_COMMAND Tokenize(char* strCommand, char** trackid, char** args)
 	return command;
 }
 
-// ParseId fills in array of ints (g_selTracks.Get()) according to id string
-void ParseTrackId(char* strId, bool bReset)
+// Track table used to evaluate track ids: lowercase names are cached so that repeated
+// commands (custom commands, cycle actions, macros) do not re-read every track name.
+// Names are invalidated on track list changes and track renames, see ConsoleTrackListChange().
+// Folder states can change without notification (indent/outdent): they are refreshed
+// on each evaluation of an id which needs them (children terms), see UpdateConsoleFolders().
+typedef struct CONSOLE_TRACK
 {
-	int track;
-	const char* cName;
-	char* p;
-	bool bChildren = false;
-	bool bInvert = false;
+	MediaTrack* tr;
+	WDL_String name; // lowercase
+	int iFolder, iType;
+} CONSOLE_TRACK;
 
-	if (!strId || !GetNumTracks())
-		return;
+static WDL_PtrList_DOD<CONSOLE_TRACK> g_consoleTracks;
+static bool g_bConsoleTracksValid = false;
 
-	if (bReset)
-	{
-		g_selTracks.Resize(GetNumTracks(), false);
-		memset(g_selTracks.Get(), 0, g_selTracks.GetSize() * sizeof(int));
-	}
+void ConsoleTrackListChange()
+{
+	g_bConsoleTracksValid = false;
+}
 
-	// Comma seperated list or whitespace? strip and recall
-	if (strchr(strId, ','))
+static void UpdateConsoleTracks()
+{
+	if (!g_bConsoleTracksValid || g_consoleTracks.GetSize() != GetNumTracks() ||
+		(GetNumTracks() && g_consoleTracks.Get(0)->tr != CSurf_TrackFromID(1, false)))
 	{
-		char temp[128];
-		char* token;
-		strncpy(temp, strId, 128);
-		temp[127]=0; // Just in case
-		token = strtok(temp, ",");
-		if (!token)
-			ParseTrackId((char*)"", false);
-		while (token)
+		g_consoleTracks.Empty(true);
+		for (int i = 0; i < GetNumTracks(); i++)
 		{
-			ParseTrackId(token, false);
-			token = strtok(NULL, ",");
+			CONSOLE_TRACK* t = g_consoleTracks.Add(new CONSOLE_TRACK);
+			t->tr = CSurf_TrackFromID(i+1, false);
+			const char* cName = (const char*)GetSetMediaTrackInfo(t->tr, "P_NAME", NULL);
+			t->name.Set(cName ? cName : "");
+			for (int j = 0; j < t->name.GetLength(); j++)
+				t->name.Get()[j] = tolower(t->name.Get()[j]);
 		}
-		return;
+		g_bConsoleTracksValid = true;
 	}
+}
 
-	// Strip out / and signify a child
-	while ((p = strchr(strId, '/')) != NULL)
+static void UpdateConsoleFolders()
+{
+	MediaTrack* gfd = NULL;
+	for (int i = 0; i < g_consoleTracks.GetSize(); i++)
 	{
-		for (; *p; p++)
-			*p = *(p+1);
-		bChildren = true;
+		CONSOLE_TRACK* t = g_consoleTracks.Get(i);
+		t->iType = 0;
+		t->iFolder = GetFolderDepth(t->tr, &t->iType, &gfd);
 	}
+}
+
+// Compiled track id: one term per comma separated token, terms are applied in order
+// to the same selection (i.e. "/" and "!" affect the tracks selected by previous terms too)
+enum { TERM_INVALID=0, TERM_ALL, TERM_SELECTED, TERM_RANGE, TERM_SUFFIX, TERM_PREFIX, TERM_CONTAINS, TERM_NONE, TERM_NUMBER_OR_NAME };
+
+typedef struct CONSOLE_TERM
+{
+	int iType;
+	int iStart, iEnd; // TERM_RANGE, TERM_NUMBER_OR_NAME (iStart)
+	WDL_String str;   // lowercase pattern
+	bool bChildren, bInvert;
+} CONSOLE_TERM;
+
+static void CompileTrackTerm(const char* strId, CONSOLE_TERM* term)
+{
+	WDL_String id;
+	term->iType = TERM_INVALID;
+	term->iStart = term->iEnd = 0;
+	term->bChildren = term->bInvert = false;
+
+	// Strip out / and signify a child
+	for (const char* p = strId; *p; p++)
+		if (*p == '/')
+			term->bChildren = true;
+		else
+			id.Append(p, 1);
 
 	// Ignore the beginning spaces
-	while (strId[0] == ' ')
-		strId++;
+	const char* str = id.Get();
+	while (str[0] == ' ')
+		str++;
 
 	// If the first char is a ! invert selection
-	if (strId[0] == '!')
+	if (str[0] == '!')
 	{
-		strId++;
-		bInvert = true;
+		str++;
+		term->bInvert = true;
 	}
 
+	int len = (int)strlen(str);
+	const char* p;
+
 	// If the string is "all" or exactly "*", select all tracks.
-	if (_stricmp(strId, __LOCALIZE("all","sws_DLG_100")) == 0 || strcmp(strId, "*") == 0)
-		for (track = 0; track < GetNumTracks(); track++)
-			g_selTracks.Get()[track] = 1;
+	if (_stricmp(str, __LOCALIZE("all","sws_DLG_100")) == 0 || strcmp(str, "*") == 0)
+		term->iType = TERM_ALL;
 
 	// If the string is empty, use the tracks' selected flags
-	else if (strId[0] == 0)
-		for (track = 0; track < GetNumTracks(); track++)
-		{
-			// If tracks were selected before (because of a comma separated list) don't change it here.
-			if (g_selTracks.Get()[track])
-				break;
-			int iSel = *((int*)GetSetMediaTrackInfo(CSurf_TrackFromID(track+1, false), "I_SELECTED", NULL));
-			g_selTracks.Get()[track] = iSel;
-		}
+	else if (str[0] == 0)
+		term->iType = TERM_SELECTED;
 
 	// If a range is specified, select those numbers
-	else if ((p = strchr(strId, '-')) != NULL)
+	else if ((p = strchr(str, '-')) != NULL)
 	{
 		// Make sure the string is valid:
 		int nondigchars = 0;
-		for (int i = 0; i < (int)strlen(strId); i++)
-			if (!isdigit(strId[i]))
+		for (int i = 0; i < len; i++)
+			if (!isdigit(str[i]))
 				nondigchars++;
-		if (nondigchars != 1)
-			return;
-
-		int start = atol(strId);
-		int end = atol(p+1);
-		if (start < 1)
-			start = 1;
-		if (end > GetNumTracks())
-			end = GetNumTracks();
-		for (track = start-1; track < end; track++)
-			g_selTracks.Get()[track] = 1;
+		if (nondigchars == 1)
+		{
+			term->iType = TERM_RANGE;
+			term->iStart = atol(str);
+			term->iEnd = atol(p+1);
+		}
 	}
-	
+
 	// If a wildcard is in the string, use loose matches
-	else if ((p = strchr(strId, '*')) != NULL)
+	else if ((p = strchr(str, '*')) != NULL)
 	{
-		char* strMatch = NULL;
-		for (track = 0; track < GetNumTracks(); track++)
+		if (str[0] == '*' && len > 2 && str[len-1] == '*')
 		{
-			cName = (const char*)GetSetMediaTrackInfo(CSurf_TrackFromID(track+1, false), "P_NAME", NULL);
-			if (cName && cName[0])
-			{
-				if (p == strId && _strnicmp(strId+1, cName+1+strlen(cName)-strlen(strId), strlen(strId)-1) == 0)
-					g_selTracks.Get()[track] = 1;
-				else if (p-strId == strlen(strId) - 1 && _strnicmp(strId, cName, strlen(strId)-1) == 0)
-					g_selTracks.Get()[track] = 1;
-				// This "should" be the double wildcard case, but check anyway
-				else if (strId[0] == '*' && strlen(strId) > 2 && strId[strlen(strId)-1] == '*')
-				{
-					if (!strMatch)
-					{
-						strMatch = new char[strlen(strId)-1];
-						lstrcpyn(strMatch, strId+1, (int)strlen(strId)-1);
-					}
-					if (stristr(cName, strMatch))
-						g_selTracks.Get()[track] = 1;
-				}
-			}
+			term->iType = TERM_CONTAINS;
+			term->str.Set(str+1, len-2);
+		}
+		else if (p == str)
+		{
+			term->iType = TERM_SUFFIX;
+			term->str.Set(str+1);
+		}
+		else if (p-str == len-1)
+		{
+			term->iType = TERM_PREFIX;
+			term->str.Set(str, len-1);
 		}
-		delete [] strMatch;
+		else
+			term->iType = TERM_NONE;
 	}
-	// Check for exact numeric
-	else if ((track = atol(strId)) > 0 && track <= GetNumTracks())
-		g_selTracks.Get()[track-1] = 1;
 
-	// Check for exact name matches, with "auto compelete"
-	//   e.g. if there's no exact match, but only one track that starts with the string, select that one
+	// Exact numeric, or exact name matches with "auto complete"
 	else
 	{
-		int iCloseMatch = 0;
-		int iExactMatch = 0;
-		int iMatchedTrack;
-		for (track = 0; track < GetNumTracks(); track++)
+		term->iType = TERM_NUMBER_OR_NAME;
+		term->iStart = atol(str);
+		term->str.Set(str);
+	}
+
+	for (int i = 0; i < term->str.GetLength(); i++)
+		term->str.Get()[i] = tolower(term->str.Get()[i]);
+}
+
+static void CompileTrackId(const char* strId, WDL_PtrList_DOD<CONSOLE_TERM>* terms)
+{
+	// Comma seperated list
+	if (strchr(strId, ','))
+	{
+		WDL_String token;
+		for (const char* p = strId; ; p++)
 		{
-			cName = (const char*)GetSetMediaTrackInfo(CSurf_TrackFromID(track+1, false), "P_NAME", NULL);
-			// Exact name match
-			if (cName[0] && _stricmp(strId, cName) == 0)
+			if (*p == ',' || !*p)
 			{
-				iExactMatch++;
-				g_selTracks.Get()[track] = 1;
+				if (token.GetLength())
+					CompileTrackTerm(token.Get(), terms->Add(new CONSOLE_TERM));
+				token.Set("");
+				if (!*p)
+					break;
 			}
-			// Exact number match
-			else if (atol(strId) == track+1)
+			else
+				token.Append(p, 1);
+		}
+		if (!terms->GetSize())
+			CompileTrackTerm("", terms->Add(new CONSOLE_TERM));
+	}
+	else
+		CompileTrackTerm(strId, terms->Add(new CONSOLE_TERM));
+}
+
+static void ApplyTrackTerm(CONSOLE_TERM* term, int* sel)
+{
+	const int nbTracks = g_consoleTracks.GetSize();
+	switch (term->iType)
+	{
+		case TERM_INVALID:
+			return; // no children/invert either
+		case TERM_ALL:
+			for (int i = 0; i < nbTracks; i++)
+				sel[i] = 1;
+			break;
+		case TERM_SELECTED:
+			for (int i = 0; i < nbTracks; i++)
 			{
-				iExactMatch++;
-				g_selTracks.Get()[track] = 1;
+				// If tracks were selected before (because of a comma separated list) don't change it here.
+				if (sel[i])
+					break;
+				sel[i] = *((int*)GetSetMediaTrackInfo(g_consoleTracks.Get(i)->tr, "I_SELECTED", NULL));
 			}
-			// Check for close match
-			else if (cName[0] && _strnicmp(strId, cName, strlen(strId)) == 0)
+			break;
+		case TERM_RANGE:
+			for (int i = max(term->iStart, 1) - 1; i < min(term->iEnd, nbTracks); i++)
+				sel[i] = 1;
+			break;
+		case TERM_SUFFIX:
+		case TERM_PREFIX:
+		case TERM_CONTAINS:
+			for (int i = 0; i < nbTracks; i++)
 			{
-				iCloseMatch++;
-				iMatchedTrack = track;
+				WDL_String* name = &g_consoleTracks.Get(i)->name;
+				if (!name->GetLength())
+					continue;
+				if (term->iType == TERM_CONTAINS ? strstr(name->Get(), term->str.Get()) != NULL :
+					term->iType == TERM_PREFIX ? !strncmp(name->Get(), term->str.Get(), term->str.GetLength()) :
+					name->GetLength() >= term->str.GetLength() && !strcmp(name->Get() + name->GetLength() - term->str.GetLength(), term->str.Get()))
+					sel[i] = 1;
 			}
-		}
-
-		if (!iExactMatch && iCloseMatch == 1)
-			g_selTracks.Get()[iMatchedTrack] = 1;
+			break;
+		case TERM_NUMBER_OR_NAME:
+			if (term->iStart > 0 && term->iStart <= nbTracks)
+				sel[term->iStart-1] = 1;
+			else
+			{
+				//   e.g. if there's no exact match, but only one track that starts with the string, select that one
+				int iCloseMatch = 0, iExactMatch = 0, iMatchedTrack = 0;
+				for (int i = 0; i < nbTracks; i++)
+				{
+					WDL_String* name = &g_consoleTracks.Get(i)->name;
+					if (!name->GetLength())
+						continue;
+					if (!strcmp(term->str.Get(), name->Get()))
+					{
+						iExactMatch++;
+						sel[i] = 1;
+					}
+					else if (!strncmp(term->str.Get(), name->Get(), term->str.GetLength()))
+					{
+						iCloseMatch++;
+						iMatchedTrack = i;
+					}
+				}
+				if (!iExactMatch && iCloseMatch == 1)
+					sel[iMatchedTrack] = 1;
+			}
+			break;
 	}
 
-	if (bChildren)
+	if (term->bChildren)
 	{
-		int iParentDepth;
+		int iParentDepth = 0;
 		bool bSelected = false;
-		MediaTrack* gfd = NULL;
-		for (int i = 0; i < GetNumTracks(); i++)
+		for (int i = 0; i < nbTracks; i++)
 		{
-			MediaTrack* tr = CSurf_TrackFromID(i+1, false);
-			int iType;
-			int iFolder = GetFolderDepth(tr, &iType, &gfd);
-
+			CONSOLE_TRACK* t = g_consoleTracks.Get(i);
 			if (bSelected)
-				g_selTracks.Get()[i] = 1;
+				sel[i] = 1;
 
-			if (iType == 1 && !bSelected && g_selTracks.Get()[i])
+			if (t->iType == 1 && !bSelected && sel[i])
 			{
-				iParentDepth = iFolder;
+				iParentDepth = t->iFolder;
 				bSelected = true;
 			}
 
-			if (iType + iFolder <= iParentDepth)
+			if (t->iType + t->iFolder <= iParentDepth)
 				bSelected = false;
 		}
 	}
 
-	if (bInvert)
+	if (term->bInvert)
+		for (int i = 0; i < nbTracks; i++)
+			sel[i] = sel[i] ? 0 : 1;
+}
+
+static void FreeTrackTerms(WDL_PtrList_DOD<CONSOLE_TERM>* terms) { delete terms; }
+
+// ParseId fills in array of ints (g_selTracks.Get()) according to id string
+void ParseTrackId(const char* strId)
+{
+	static WDL_StringKeyedArray<WDL_PtrList_DOD<CONSOLE_TERM>*> sCompiled(true, FreeTrackTerms);
+
+	if (!strId || !GetNumTracks())
+		return;
+
+	UpdateConsoleTracks();
+	g_selTracks.Resize(GetNumTracks(), false);
+	memset(g_selTracks.Get(), 0, g_selTracks.GetSize() * sizeof(int));
+
+	WDL_PtrList_DOD<CONSOLE_TERM>* terms = sCompiled.Get(strId, NULL);
+	if (!terms)
 	{
-		for (int i = 0; i < GetNumTracks(); i++)
-			g_selTracks.Get()[i] = g_selTracks.Get()[i] ? 0 : 1;
+		if (sCompiled.GetSize() >= 256) // typed ids in the console window, custom commands, etc..
+			sCompiled.DeleteAll();
+		terms = new WDL_PtrList_DOD<CONSOLE_TERM>;
+		CompileTrackId(strId, terms);
+		sCompiled.Insert(strId, terms);
 	}
+
+	for (int i = 0; i < terms->GetSize(); i++)
+	{
+		if (terms->Get(i)->bChildren)
+		{
+			UpdateConsoleFolders();
+			break;
+		}
+	}
+
+	for (int i = 0; i < terms->GetSize(); i++)
+		ApplyTrackTerm(terms->Get(i), g_selTracks.Get());
 }
 
 // Here's where we actually do the command from the user
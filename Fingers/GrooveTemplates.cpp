@@ -43,24 +43,49 @@ void GrooveTemplateHandler::ClearGroove()
     me->grooveInBeats.clear();
 }
 
+static bool sortGrooveItems(const GrooveItem &lhs, const GrooveItem &rhs)
+{
+    return lhs.position < rhs.position;
+}
+
+/* grooveInBeats must be sorted by position (see createGrooveVector) */
 static bool GetGrooveBeatPosition(double currentBeatPosition, double maxBeatDistance, 
                                   double strength, std::vector<GrooveItem> *grooveInBeats,
                                   GrooveItem &newGroove)
 {
-    /* get max distance position */
+    if(grooveInBeats->empty())
+        return false;
+
+    /* the nearest beat is either the first one at or after the position, or the one
+       just before it; on equal distances the earliest beat wins */
+    GrooveItem key;
+    key.position = currentBeatPosition;
+    std::vector<GrooveItem>::iterator right = std::lower_bound(grooveInBeats->begin(), grooveInBeats->end(), key, sortGrooveItems);
+
     double minDistance = maxBeatDistance;
     bool positive = true;
-    for (std::vector<GrooveItem>::iterator it = grooveInBeats->begin(); it != grooveInBeats->end();
-         ++it)
-    {
-        double distance = currentBeatPosition - it->position;
-        if( abs(distance) < minDistance) {
+    bool found = false;
+    if(right != grooveInBeats->begin()) {
+        key.position = (right - 1)->position;
+        std::vector<GrooveItem>::iterator left = std::lower_bound(grooveInBeats->begin(), right, key, sortGrooveItems);
+        double distance = currentBeatPosition - left->position;
+        if(abs(distance) < minDistance) {
             positive = distance > 0 ? true : false;
             minDistance = abs(distance);
-            newGroove = *it;
+            newGroove = *left;
+            found = true;
         }
     }
-    if(minDistance >= maxBeatDistance) {
+    if(right != grooveInBeats->end()) {
+        double distance = currentBeatPosition - right->position;
+        if(abs(distance) < minDistance) {
+            positive = distance > 0 ? true : false;
+            minDistance = abs(distance);
+            newGroove = *right;
+            found = true;
+        }
+    }
+    if(!found) {
         return false;
     }
 
@@ -193,6 +218,12 @@ static void applyGrooveToMidiTake(RprMidiTake &midiTake, double beatDivider, dou
                                   std::vector<GrooveItem> &grooveBeats, bool selectedOnly)
 {
     RprItem rprItem = *midiTake.getParent();
+
+    /* fudge factor for issue 348 */
+    static const double epsilon = 0.0000000001;
+    double itemFirstBeat = TimeToBeat(rprItem.getPosition()) - epsilon;
+    double itemLastBeat = TimeToBeat(rprItem.getPosition() + rprItem.getLength());
+
     for(int i = 0; i < midiTake.countNotes(); i++) {
         RprMidiNote *note = midiTake.getNoteAt(i);
         if(selectedOnly && !note->isSelected())
@@ -202,10 +233,6 @@ static void applyGrooveToMidiTake(RprMidiTake &midiTake, double beatDivider, dou
         if(!GetGrooveBeatPosition(noteBeat, BeatsInMeasure(BeatToMeasure(noteBeat)) / beatDivider, positionStrength, &grooveBeats, grooveItem))
             continue;
 
-                /* fudge factor for issue 348 */
-                static const double epsilon = 0.0000000001;
-        double itemFirstBeat = TimeToBeat(rprItem.getPosition()) - epsilon;
-        double itemLastBeat = TimeToBeat(rprItem.getPosition() + rprItem.getLength());
         if(grooveItem.position >= itemFirstBeat && grooveItem.position < itemLastBeat) {
             note->setPosition(BeatToTime(grooveItem.position));
             if(grooveItem.amplitude >= 0.0) {
@@ -258,6 +285,8 @@ static void createGrooveVector(double leftEdge, double rightEdge, std::vector<Gr
             }
         }
     }
+    /* already in order for grooves within [0, nBeatsInGroove[, GetGrooveBeatPosition() relies on it */
+    std::stable_sort(outputGrooveBeats.begin(), outputGrooveBeats.end(), sortGrooveItems);
 }
 
 bool treatAsMidiTake(RprMidiTake &midiTake)
@@ -327,20 +356,29 @@ void GrooveTemplateHandler::ApplyGroove(int beatDivider, double posStrength, dou
         grooveBeats);
 
     /* apply groove to midi notes and media items */
-    for(int i = 0; i < ctr->size(); i++) {
-        RprItem rprItem = ctr->getAt(i);
-        if(!rprItem.getActiveTake().isMIDI()) {
-            applyGrooveToItem(rprItem, (double)beatDivider, posStrength, grooveBeats);
-            continue;
-        }
+    PreventUIRefresh(1);
+    try {
+        for(int i = 0; i < ctr->size(); i++) {
+            RprItem rprItem = ctr->getAt(i);
+            if(!rprItem.getActiveTake().isMIDI()) {
+                applyGrooveToItem(rprItem, (double)beatDivider, posStrength, grooveBeats);
+                continue;
+            }
 
-        RprMidiTake midiTake(rprItem.getActiveTake());
-        if(treatAsMidiTake(midiTake))
-            applyGrooveToMidiTake(midiTake, (double)beatDivider, posStrength, velStrength, grooveBeats, false);
-        else
-            applyGrooveToItem(rprItem, (double)beatDivider, posStrength, grooveBeats);
+            RprMidiTake midiTake(rprItem.getActiveTake());
+            if(treatAsMidiTake(midiTake))
+                applyGrooveToMidiTake(midiTake, (double)beatDivider, posStrength, velStrength, grooveBeats, false);
+            else
+                applyGrooveToItem(rprItem, (double)beatDivider, posStrength, grooveBeats);
 
+        }
+    }
+    catch(...) {
+        /* RprMidiTake throws on unparsable MIDI, callers report it */
+        PreventUIRefresh(-1);
+        throw;
     }
+    PreventUIRefresh(-1);
     UpdateTimeline();
 }
 
@@ -391,11 +429,6 @@ static int GetMidiBeatPositions(RprMidiTake &midiTake, const RprItem &parent, st
     return (int)vPositions.size();
 }
 
-static bool sortGrooveItems(const GrooveItem &lhs, const GrooveItem &rhs)
-{
-    return lhs.position < rhs.position;
-}
-
 static bool isGrooveItemUnique(const GrooveItem &lhs, const GrooveItem &rhs)
 {
     return lhs.position == rhs.position;
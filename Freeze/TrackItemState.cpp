@@ -33,6 +33,24 @@
 // Globals
 SWSProjConfig<WDL_PtrList_DOD<TrackState> > g_tracks;
 
+void BuildItemGuidMap(MediaTrack* tr, ItemGuidMap* items)
+{
+	items->clear();
+	for (int i = 0; i < GetTrackNumMediaItems(tr); i++)
+	{
+		MediaItem* mi = GetTrackMediaItem(tr, i);
+		// First item wins on duplicate GUIDs, as with the former linear search
+		items->insert(make_pair(*(GUID*)GetSetMediaItemInfo(mi, "GUID", NULL), mi));
+	}
+}
+
+// Only write item properties that actually change
+template <typename T> static void SetItemInfo(MediaItem* mi, const char* parm, const T* val)
+{
+	if (*(T*)GetSetMediaItemInfo(mi, parm, NULL) != *val)
+		GetSetMediaItemInfo(mi, parm, (void*)val);
+}
+
 //*****************************************************
 // ItemState Class
 ItemState::ItemState(LineParser* lp)
@@ -71,39 +89,32 @@ ItemState::ItemState(MediaItem* mi)
 	m_dFadeOut = *(double*)GetSetMediaItemInfo(mi, "D_FADEOUTLEN", NULL);
 }
 
-MediaItem* ItemState::FindItem(MediaTrack* tr)
+MediaItem* ItemState::FindItem(const ItemGuidMap& items)
 {
-	// Find the media item in the track
-	MediaItem* mi = NULL;
-	for (int i = 0; i < GetTrackNumMediaItems(tr); i++)
-	{
-		mi = GetTrackMediaItem(tr, i);
-		if (GuidsEqual(&m_guid, (GUID*)GetSetMediaItemInfo(mi, "GUID", NULL)))
-			return mi;
-	}
-	return NULL;
+	ItemGuidMap::const_iterator it = items.find(m_guid);
+	return it != items.end() ? it->second : NULL;
 }
 
-void ItemState::Restore(MediaTrack* tr, bool bSelOnly)
+void ItemState::Restore(const ItemGuidMap& items, bool bSelOnly)
 {
 	// First gotta find the media item in the track
-	MediaItem* mi = FindItem(tr);
+	MediaItem* mi = FindItem(items);
 	if (mi == NULL)
 		return;
 	if (!bSelOnly || *(bool*)GetSetMediaItemInfo(mi, "B_UISEL", NULL))
 	{
-		GetSetMediaItemInfo(mi, "B_MUTE", &m_bMute);
-		GetSetMediaItemInfo(mi, "F_FREEMODE_Y", &m_fFIPMy);
-		GetSetMediaItemInfo(mi, "F_FREEMODE_H", &m_fFIPMh);
+		SetItemInfo(mi, "B_MUTE", &m_bMute);
+		SetItemInfo(mi, "F_FREEMODE_Y", &m_fFIPMy);
+		SetItemInfo(mi, "F_FREEMODE_H", &m_fFIPMh);
 		if (!bSelOnly)
-			GetSetMediaItemInfo(mi, "B_UISEL", &m_bSel);
-		GetSetMediaItemInfo(mi, "I_CUSTOMCOLOR", &m_iColor);
+			SetItemInfo(mi, "B_UISEL", &m_bSel);
+		SetItemInfo(mi, "I_CUSTOMCOLOR", &m_iColor);
 		if (m_dVol >= 0.0)
-			GetSetMediaItemInfo(mi, "D_VOL", &m_dVol);
+			SetItemInfo(mi, "D_VOL", &m_dVol);
 		if (m_dFadeIn >= 0.0)
-			GetSetMediaItemInfo(mi, "D_FADEINLEN", &m_dFadeIn);
+			SetItemInfo(mi, "D_FADEINLEN", &m_dFadeIn);
 		if (m_dFadeOut >= 0.0)
-			GetSetMediaItemInfo(mi, "D_FADEOUTLEN", &m_dFadeOut);
+			SetItemInfo(mi, "D_FADEOUTLEN", &m_dFadeOut);
 	}
 }
 
@@ -115,12 +126,12 @@ char* ItemState::ItemString(char* str, int maxLen)
 	return str;
 }
 
-void ItemState::Select(MediaTrack* tr)
+void ItemState::Select(const ItemGuidMap& items)
 {
-	MediaItem* mi = FindItem(tr);
+	MediaItem* mi = FindItem(items);
 	if (mi == NULL)
 		return;
-	GetSetMediaItemInfo(mi, "B_UISEL", &g_bTrue);
+	SetItemInfo(mi, "B_UISEL", &g_bTrue);
 }
 
 //*****************************************************
@@ -158,22 +169,28 @@ TrackState::~TrackState()
 
 void TrackState::AddSelItems(MediaTrack* tr)
 {
+	// Saved states by item GUID (first one wins, as with the former linear search)
+	map<GUID, int, GUIDLess> saved;
+	for (int j = 0; j < m_items.GetSize(); j++)
+		saved.insert(make_pair(m_items.Get(j)->m_guid, j));
+
 	for (int i = 0; i < GetTrackNumMediaItems(tr); i++)
 	{
 		MediaItem* mi = GetTrackMediaItem(tr, i);
 		if (*(bool*)GetSetMediaItemInfo(mi, "B_UISEL", NULL))
 		{
-			int j;
-			for (j = 0; j < m_items.GetSize(); j++)
-				if (mi == m_items.Get(j)->FindItem(tr))
-				{
-					ItemState* is = m_items.Get(j);
-					m_items.Set(j, new ItemState(mi));
-					delete is;
-					break;
-				}
-			if (j == m_items.GetSize())
-				m_items.Add(new ItemState(mi));
+			ItemState* newState = new ItemState(mi);
+			map<GUID, int, GUIDLess>::iterator it = saved.find(newState->m_guid);
+			if (it != saved.end())
+			{
+				delete m_items.Get(it->second);
+				m_items.Set(it->second, newState);
+			}
+			else
+			{
+				saved.insert(make_pair(newState->m_guid, m_items.GetSize()));
+				m_items.Add(newState);
+			}
 		}
 	}
 }
@@ -181,7 +198,11 @@ void TrackState::AddSelItems(MediaTrack* tr)
 void TrackState::UnselAllItems(MediaTrack* tr)
 {
 	for (int i = 0; i < GetTrackNumMediaItems(tr); i++)
-		GetSetMediaItemInfo(GetTrackMediaItem(tr, i), "B_UISEL", &g_bFalse);
+	{
+		MediaItem* mi = GetTrackMediaItem(tr, i);
+		if (*(bool*)GetSetMediaItemInfo(mi, "B_UISEL", NULL))
+			GetSetMediaItemInfo(mi, "B_UISEL", &g_bFalse);
+	}
 }
 
 void TrackState::Restore(MediaTrack* tr, bool bSelOnly)
@@ -195,8 +216,10 @@ void TrackState::Restore(MediaTrack* tr, bool bSelOnly)
 		GetSetMediaTrackInfo(tr, "B_FREEMODE", &m_bFIPM);
 		GetSetMediaTrackInfo(tr, "I_CUSTOMCOLOR", &m_iColor);
 	}
+	ItemGuidMap items;
+	BuildItemGuidMap(tr, &items);
 	for (int i = 0; i < m_items.GetSize(); i++)
-		m_items.Get(i)->Restore(tr, bSelOnly);
+		m_items.Get(i)->Restore(items, bSelOnly);
 }
 
 char* TrackState::ItemString(char* str, int maxLen)
@@ -210,8 +233,10 @@ char* TrackState::ItemString(char* str, int maxLen)
 void TrackState::SelectItems(MediaTrack* tr)
 {
 	UnselAllItems(tr);
+	ItemGuidMap items;
+	BuildItemGuidMap(tr, &items);
 	for (int i = 0; i < m_items.GetSize(); i++)
-		m_items.Get(i)->Select(tr);
+		m_items.Get(i)->Select(items);
 }
 
 //*****************************************************
@@ -28,15 +28,19 @@
 
 #pragma once
 
+// Items of a track by GUID, built once per restore/select rather than scanning the track per saved item
+typedef std::map<GUID, MediaItem*, GUIDLess> ItemGuidMap;
+void BuildItemGuidMap(MediaTrack* tr, ItemGuidMap* items);
+
 class ItemState
 {
 public:
 	ItemState(LineParser* lp);
 	ItemState(MediaItem* mi);
-	MediaItem* FindItem(MediaTrack* tr);
-	void Restore(MediaTrack* tr, bool bSelOnly);
+	MediaItem* FindItem(const ItemGuidMap& items);
+	void Restore(const ItemGuidMap& items, bool bSelOnly);
     char* ItemString(char* str, int maxLen);
-	void Select(MediaTrack* tr);
+	void Select(const ItemGuidMap& items);
 
 	GUID m_guid;
 	bool m_bMute;
@@ -214,25 +214,128 @@ void LabelProcessor(COMMAND_T* ct)
 	RunLabelCommand(&format, SWS_CMD_SHORTNAME(ct));
 }
 
+// Compiled label template: literal spans of the template string and field ops with their
+// arguments, so that the template is parsed once rather than once per take
+enum
+{
+	LABEL_OP_LITERAL=0,
+	LABEL_OP_DURATION,		// /D
+	LABEL_OP_ENUM,			// /E
+	LABEL_OP_ENUM_TRACK,	// /e
+	LABEL_OP_INV_ENUM,		// /I
+	LABEL_OP_INV_ENUM_TRACK,// /i
+	LABEL_OP_TAKE_COUNT,	// /K
+	LABEL_OP_TAKE_NUM,		// /k
+	LABEL_OP_LABEL,			// /L
+	LABEL_OP_OFFSET,		// /O
+	LABEL_OP_PEAK,			// /P
+	LABEL_OP_RMS_MAX,		// /R
+	LABEL_OP_RMS_AVG,		// /r
+	LABEL_OP_SRC_PATH,		// /S
+	LABEL_OP_SRC_FILE,		// /s
+	LABEL_OP_TRACK_NAME,	// /T
+	LABEL_OP_TRACK_NUM		// /t
+};
+
+struct LabelOp
+{
+	int type;
+	int args[2];
+	int litStart, litLen; // LABEL_OP_LITERAL only, span in the template string
+};
+
+static void AddLabelLiteral(WDL_TypedBuf<LabelOp>* prog, int start, int len)
+{
+	int sz = prog->GetSize();
+	LabelOp* last = sz ? prog->Get() + sz - 1 : NULL;
+	if (last && last->type == LABEL_OP_LITERAL && last->litStart + last->litLen == start)
+	{
+		last->litLen += len;
+		return;
+	}
+	LabelOp op = { LABEL_OP_LITERAL, {0,0}, start, len };
+	prog->Add(op);
+}
+
+static void AddLabelOp(WDL_TypedBuf<LabelOp>* prog, int type, const char *&c, int arg0, int arg1, int maxArgs)
+{
+	LabelOp op = { type, {arg0,arg1}, 0, 0 };
+	if (maxArgs)
+		ExtractValues(++c, op.args, maxArgs);
+	else
+		++c;
+	prog->Add(op);
+}
+
+// Parsing rules are unchanged: unknown /x sequences are kept as is, /D and /O take no argument
+static void CompileLabelTemplate(const char* cmd, WDL_TypedBuf<LabelOp>* prog)
+{
+	prog->Resize(0, false);
+
+	const char *c = cmd;
+	const char *end = strchr(c, 0);
+	while(c < end)
+	{
+		if (*c != '/')
+		{
+			AddLabelLiteral(prog, (int)(c - cmd), 1);
+			++c;
+			continue;
+		}
+
+		switch(*(++c))
+		{
+		default :  AddLabelLiteral(prog, (int)(c - 1 - cmd), 1); break;
+		case 'D' : AddLabelOp(prog, LABEL_OP_DURATION, c, 0, 0, 0); break;
+		case 'E' : AddLabelOp(prog, LABEL_OP_ENUM, c, 2, 1, 2); break;
+		case 'e' : AddLabelOp(prog, LABEL_OP_ENUM_TRACK, c, 2, 1, 2); break;
+		case 'I' : AddLabelOp(prog, LABEL_OP_INV_ENUM, c, 2, 0, 2); break;
+		case 'i' : AddLabelOp(prog, LABEL_OP_INV_ENUM_TRACK, c, 2, 0, 2); break;
+		case 'K' : AddLabelOp(prog, LABEL_OP_TAKE_COUNT, c, 1, 0, 1); break;
+		case 'k' : AddLabelOp(prog, LABEL_OP_TAKE_NUM, c, 1, 0, 1); break;
+		case 'L' : AddLabelOp(prog, LABEL_OP_LABEL, c, 0, 0, 2); break;
+		case 'O' : AddLabelOp(prog, LABEL_OP_OFFSET, c, 0, 0, 0); break;
+		case 'P' : AddLabelOp(prog, LABEL_OP_PEAK, c, 1, 0, 1); break;
+		case 'R' : AddLabelOp(prog, LABEL_OP_RMS_MAX, c, 1, 0, 1); break;
+		case 'r' : AddLabelOp(prog, LABEL_OP_RMS_AVG, c, 1, 0, 1); break;
+		case 'S' : AddLabelOp(prog, LABEL_OP_SRC_PATH, c, 0, 0, 2); break;
+		case 's' : AddLabelOp(prog, LABEL_OP_SRC_FILE, c, 0, 0, 2); break;
+		case 'T' : AddLabelOp(prog, LABEL_OP_TRACK_NAME, c, 0, 0, 2); break;
+		case 't' : AddLabelOp(prog, LABEL_OP_TRACK_NUM, c, 2, 0, 1); break;
+		}
+	}
+}
+
 void RunLabelCommand(WDL_FastString* cmd, const char* undoName)
 {
-	if (undoName)
-		Undo_BeginBlock2(NULL);
+	WDL_TypedBuf<LabelOp> prog;
+	CompileLabelTemplate(cmd->Get(), &prog);
+	const LabelOp* ops = prog.Get();
+	const int nbOps = prog.GetSize();
+
+	// 1st pass: build all new names, 2nd pass: rename
+	// (new names are stored NUL-terminated in a single buffer, one offset per take)
+	WDL_TypedBuf<MediaItem_Take*> renamedTakes;
+	WDL_TypedBuf<char> newNames;
+	WDL_TypedBuf<int> newNameOffsets;
 
 	char buf[512];
 	int itemCount = 0;
 	const int numSel = CountSelectedMediaItems(NULL);
+	WDL_TypedBuf<MediaItem*> items;
+	WDL_TypedBuf<MediaItem_Take*> takes;
+	WDL_FastString str;
 	for (int iTrack = 1; iTrack <= GetNumTracks(); iTrack++)
 	{
-		WDL_TypedBuf<MediaItem*> items;
-		SWS_GetSelectedMediaItemsOnTrack(&items, CSurf_TrackFromID(iTrack, false));
+		MediaTrack* tr = CSurf_TrackFromID(iTrack, false);
+		SWS_GetSelectedMediaItemsOnTrack(&items, tr);
 		int numSelOnTrack = items.GetSize();
 		for (int i = 0; i < numSelOnTrack; i++)
 		{
 			MediaItem* pItem = items.Get()[i];
 
 			// Build take list
-			WDL_TypedBuf<MediaItem_Take*> takes;
+			takes.Resize(0, false);
 			if(bAllTakes)
 			{
 				for(int t = 0, tc = GetMediaItemNumTakes(pItem); t < tc; t++)
@@ -250,195 +353,128 @@ void RunLabelCommand(WDL_FastString* cmd, const char* undoName)
 			{
 				MediaItem_Take* pTake = takes.Get()[t];
 
-				WDL_FastString str;
-
-				const char *c = cmd->Get();
-				const char *end = strchr(c, 0);
-
-				while(c < end)
+				str.Set("");
+				for (int o = 0; o < nbOps; o++)
 				{
-					switch(*c)
+					const LabelOp* op = ops + o;
+					switch(op->type)
 					{
-					case '/' :
-						{
-							switch(*(++c))
-							{
-							default :
-								str.Append("/");
-								break;
-
-							case 'D' : // Duration
-								{
-									double length = *(double*) GetSetMediaItemInfo(pItem, "D_LENGTH", NULL);
-									format_timestr(length, buf, sizeof(buf));
-									str.AppendFormatted(str.GetLength() + (int)strlen(buf), "%s", buf);
-									++c;
-								}
-								break;
-
-							case 'E' : // Enumerate all
-								{
-									int args[2] = {2,1};
-									ExtractValues(++c, args, 2);
-									str.AppendFormatted(str.GetLength() + 8, "%0*d", args[0], itemCount + args[1]);
-								}
-								break;
-
-							case 'e' : // Enumerate on track
-								{
-									int args[2] = {2,1};
-									ExtractValues(++c, args, 2);
-									str.AppendFormatted(str.GetLength() + 8, "%0*d", args[0], i + args[1]);
-								}
-								break;
-
-							case 'I' : // Inverse enumerate all
-								{
-									int args[2] = {2,0};
-									ExtractValues(++c, args, 2);
-									str.AppendFormatted(str.GetLength() + 8, "%0*d", args[0], numSel - itemCount + args[1] - 1);
-								}
-								break;
-
-							case 'i' : // Inverse enumerate on track
-								{
-									int args[2] = {2,0};
-									ExtractValues(++c, args, 2);
-									str.AppendFormatted(str.GetLength() + 8, "%0*d", args[0], numSelOnTrack - i + args[1] - 1);
-								}
-								break;
+					case LABEL_OP_LITERAL :
+						str.Append(cmd->Get() + op->litStart, op->litLen);
+						break;
 
-							case 'K' : // Take count
-								{
-									int digits = 1;
-									ExtractValues(++c, &digits, 1);
-									str.AppendFormatted(str.GetLength() + digits, "%0*d", digits, tc);
-								}
-								break;
+					case LABEL_OP_DURATION :
+						{
+							double length = *(double*) GetSetMediaItemInfo(pItem, "D_LENGTH", NULL);
+							format_timestr(length, buf, sizeof(buf));
+							str.AppendFormatted(str.GetLength() + (int)strlen(buf), "%s", buf);
+						}
+						break;
 
-							case 'k' : // Take number
-								{
-									int digits = 1;
-									ExtractValues(++c, &digits, 1);
-									str.AppendFormatted(str.GetLength() + digits, "%0*d", digits, t + 1);
-								}
-								break;
+					case LABEL_OP_ENUM :
+						str.AppendFormatted(str.GetLength() + 8, "%0*d", op->args[0], itemCount + op->args[1]);
+						break;
 
-							case 'L' : // Current label
-								{
-									int args[2] = {0,0};
-									ExtractValues(++c, args, 2);
+					case LABEL_OP_ENUM_TRACK :
+						str.AppendFormatted(str.GetLength() + 8, "%0*d", op->args[0], i + op->args[1]);
+						break;
 
-									const char *label = (const char*) GetSetMediaItemTakeInfo(pTake, "P_NAME", NULL);
-									if(label)
-										str.Append(GetSubString(label, args[0], args[1]));
-								}
-								break;
+					case LABEL_OP_INV_ENUM :
+						str.AppendFormatted(str.GetLength() + 8, "%0*d", op->args[0], numSel - itemCount + op->args[1] - 1);
+						break;
 
-							case 'O' : // Source offset
-								{
-									double offset = *(double*) GetSetMediaItemTakeInfo(pTake, "D_STARTOFFS", NULL);
-									format_timestr(offset, buf, sizeof(buf));
-									str.AppendFormatted(str.GetLength() + (int)strlen(buf), "%s", buf);
-									++c;
-								}
-								break;
+					case LABEL_OP_INV_ENUM_TRACK :
+						str.AppendFormatted(str.GetLength() + 8, "%0*d", op->args[0], numSelOnTrack - i + op->args[1] - 1);
+						break;
 
-							case 'P' : // Peak
-								{
-									int precision = 1;
-									ExtractValues(++c, &precision, 1);
-									str.Append(GetItemVolString(pItem, 0, precision));
-								}
-								break;
+					case LABEL_OP_TAKE_COUNT :
+						str.AppendFormatted(str.GetLength() + op->args[0], "%0*d", op->args[0], tc);
+						break;
 
-							case 'R' : // RMS Max
-								{
-									int precision = 1;
-									ExtractValues(++c, &precision, 1);
-									str.Append(GetItemVolString(pItem, 2, precision));
-								}
-								break;
+					case LABEL_OP_TAKE_NUM :
+						str.AppendFormatted(str.GetLength() + op->args[0], "%0*d", op->args[0], t + 1);
+						break;
 
-							case 'r' : // RMS Avg
-								{
-									int precision = 1;
-									ExtractValues(++c, &precision, 1);
-									str.Append(GetItemVolString(pItem, 1, precision));
-								}
-								break;
+					case LABEL_OP_LABEL :
+						{
+							const char *label = (const char*) GetSetMediaItemTakeInfo(pTake, "P_NAME", NULL);
+							if(label)
+								str.Append(GetSubString(label, op->args[0], op->args[1]));
+						}
+						break;
 
-							case 'S' : // Source full path
-								{
-									int args[2] = {0,0};
-									ExtractValues(++c, args, 2);
-
-									PCM_source *pSource = (PCM_source*) GetSetMediaItemTakeInfo(pTake, "P_SOURCE", NULL);
-									if(pSource)
-									{
-										memset(buf, 0, sizeof(buf));
-										GetMediaSourceFileName(pSource, buf, sizeof(buf));
-										if(*buf)
-											str.Append(GetSubString(buf, args[0], args[1]));
-									}
-								}
-								break;
+					case LABEL_OP_OFFSET :
+						{
+							double offset = *(double*) GetSetMediaItemTakeInfo(pTake, "D_STARTOFFS", NULL);
+							format_timestr(offset, buf, sizeof(buf));
+							str.AppendFormatted(str.GetLength() + (int)strlen(buf), "%s", buf);
+						}
+						break;
 
-							case 's' : // Source filename only
-								{
-									int args[2] = {0,0};
-									ExtractValues(++c, args, 2);
-
-									PCM_source *pSource = (PCM_source*) GetSetMediaItemTakeInfo(pTake, "P_SOURCE", NULL);
-									if(pSource)
-									{
-										memset(buf, 0, sizeof(buf));
-										GetMediaSourceFileName(pSource, buf, sizeof(buf));
-										if(*buf)
-										{
-											const char *f = strrchr(buf, PATH_SLASH_CHAR);
-											if(f)
-												str.Append(GetSubString(f + 1, args[0], args[1]));
-										}
-									}
-								}
-								break;
+					case LABEL_OP_PEAK :
+						str.Append(GetItemVolString(pItem, 0, op->args[0]));
+						break;
 
-							case 'T' : // Track name
-								{
-									int args[2] = {0,0};
-									ExtractValues(++c, args, 2);
+					case LABEL_OP_RMS_MAX :
+						str.Append(GetItemVolString(pItem, 2, op->args[0]));
+						break;
 
-									const char *label = (const char*) GetSetMediaTrackInfo(GetMediaItem_Track(pItem), "P_NAME", NULL);
-									if(label)
-										str.Append(GetSubString(label, args[0], args[1]));
-								}
-								break;
+					case LABEL_OP_RMS_AVG :
+						str.Append(GetItemVolString(pItem, 1, op->args[0]));
+						break;
 
-							case 't' : // Track index
+					case LABEL_OP_SRC_PATH :
+					case LABEL_OP_SRC_FILE :
+						{
+							PCM_source *pSource = (PCM_source*) GetSetMediaItemTakeInfo(pTake, "P_SOURCE", NULL);
+							if(pSource)
+							{
+								memset(buf, 0, sizeof(buf));
+								GetMediaSourceFileName(pSource, buf, sizeof(buf));
+								if(*buf)
 								{
-									int width = 2;
-									ExtractValues(++c, &width, 1);
-									str.AppendFormatted(str.GetLength() + 8, "%0*d", width, iTrack);
+									if (op->type == LABEL_OP_SRC_PATH)
+										str.Append(GetSubString(buf, op->args[0], op->args[1]));
+									else if (const char *f = strrchr(buf, PATH_SLASH_CHAR))
+										str.Append(GetSubString(f + 1, op->args[0], op->args[1]));
 								}
-								break;
 							}
 						}
 						break;
 
-					default :
-						str.Append(c++, 1);
+					case LABEL_OP_TRACK_NAME :
+						{
+							const char *label = (const char*) GetSetMediaTrackInfo(tr, "P_NAME", NULL);
+							if(label)
+								str.Append(GetSubString(label, op->args[0], op->args[1]));
+						}
+						break;
+
+					case LABEL_OP_TRACK_NUM :
+						str.AppendFormatted(str.GetLength() + 8, "%0*d", op->args[0], iTrack);
 						break;
 					}
 				}
 
-				GetSetMediaItemTakeInfo(pTake, "P_NAME", (void*) str.Get());
+				const int offset = newNames.GetSize();
+				renamedTakes.Add(pTake);
+				newNameOffsets.Add(offset);
+				newNames.Resize(offset + str.GetLength() + 1, false);
+				memcpy(newNames.Get() + offset, str.Get(), str.GetLength() + 1);
 			}
 
 			++itemCount;
 		}
 	}
 
+	if (undoName)
+		Undo_BeginBlock2(NULL);
+
+	PreventUIRefresh(1);
+	for (int i = 0; i < renamedTakes.GetSize(); i++)
+		GetSetMediaItemTakeInfo(renamedTakes.Get()[i], "P_NAME", (void*) (newNames.Get() + newNameOffsets.Get()[i]));
+	PreventUIRefresh(-1);
+
 	if (undoName)
 		Undo_EndBlock2(NULL, undoName, UNDO_STATE_ITEMS);
 
@@ -28,6 +28,8 @@
 #include "IX.h"
 #include "../reaper/localize.h"
 
+#include <taglib/fileref.h>
+#include <taglib/audioproperties.h>
 
 struct SPlaylistEntry
 {
@@ -35,6 +37,7 @@ struct SPlaylistEntry
 	string title;
 	string path;
 	bool exists;
+	int channels;		// probed, 0 if unknown
 };
 
 // Fill outbuf with filenames retrieved from playlist
@@ -192,6 +195,83 @@ void ParsePLS(string listpath, vector<SPlaylistEntry> &filelist)
 	file.close();
 }
 
+// Sources are probed by a few worker threads before insertion (file I/O only, no
+// REAPER API calls): this also warms up the OS file cache for the PCM sources
+#define PLAYLIST_PROBE_THREADS 8
+#define PLAYLIST_PROBE_MIN_PER_THREAD 16
+
+struct SProbeJob
+{
+	vector<SPlaylistEntry> *filelist;
+	size_t first;
+	size_t step;
+};
+
+// Like the API's file_exists() (false for folders), but safe to call from worker threads
+bool PlaylistFileExists(const char *path)
+{
+	struct stat s;
+#ifdef _WIN32
+	if(statUTF8(path, &s) != 0)
+#else
+	if(stat(path, &s) != 0)
+#endif
+		return false;
+	return !(s.st_mode & S_IFDIR);
+}
+
+void ProbePlaylistEntry(SPlaylistEntry &e)
+{
+	e.exists = PlaylistFileExists(e.path.c_str());
+	e.channels = 0;
+
+	if(!e.exists)
+		return;
+
+	TagLib::FileRef f(win32::widen(e.path).c_str(), true, TagLib::AudioProperties::Fast);
+	if(!f.isNull() && f.audioProperties())
+		e.channels = f.audioProperties()->channels();
+}
+
+unsigned int WINAPI ProbeThreadFunc(void *p)
+{
+	SProbeJob *job = (SProbeJob*)p;
+	for(size_t i = job->first; i < job->filelist->size(); i += job->step)
+		ProbePlaylistEntry(job->filelist->at(i));
+	return 0;
+}
+
+void ProbePlaylistEntries(vector<SPlaylistEntry> &filelist)
+{
+	int nThreads = min<int>(PLAYLIST_PROBE_THREADS, (int)(filelist.size() / PLAYLIST_PROBE_MIN_PER_THREAD));
+	if(nThreads < 2)
+	{
+		for(SPlaylistEntry &e : filelist)
+			ProbePlaylistEntry(e);
+		return;
+	}
+
+	SProbeJob jobs[PLAYLIST_PROBE_THREADS];
+	HANDLE threads[PLAYLIST_PROBE_THREADS];
+	for(int t = 0; t < nThreads; t++)
+	{
+		jobs[t].filelist = &filelist;
+		jobs[t].first = t;
+		jobs[t].step = nThreads;
+		threads[t] = (HANDLE)_beginthreadex(NULL, 0, ProbeThreadFunc, &jobs[t], 0, NULL);
+		if(!threads[t]) // do this share on the main thread
+			ProbeThreadFunc(&jobs[t]);
+	}
+	for(int t = 0; t < nThreads; t++)
+	{
+		if(threads[t])
+		{
+			WaitForSingleObject(threads[t], INFINITE);
+			CloseHandle(threads[t]);
+		}
+	}
+}
+
 // Import local files from m3u/pls playlists onto a new track
 void PlaylistImport(COMMAND_T* ct)
 {
@@ -224,13 +304,16 @@ void PlaylistImport(COMMAND_T* ct)
 	}
 
 	// Validate files
+	ProbePlaylistEntries(filelist);
+
 	size_t badfiles = 0;
-	for(SPlaylistEntry &e : filelist)
+	int channels = 2;
+	for(const SPlaylistEntry &e : filelist)
 	{
-		e.exists = file_exists(e.path.c_str());
-
 		if(!e.exists)
 			++badfiles;
+		else if(e.channels > channels)
+			channels = e.channels;
 	}
 
 	// If files can't be found, ask user what to do.
@@ -266,6 +349,7 @@ void PlaylistImport(COMMAND_T* ct)
 	}
 
 	Undo_BeginBlock2(NULL);
+	PreventUIRefresh(1);
 
 	// Add new track
 	int idx = GetNumTracks();
@@ -278,6 +362,13 @@ void PlaylistImport(COMMAND_T* ct)
 	GetSetMediaTrackInfo(pTrack, "D_PANLAW", (void*) &panLaw);
 	SetOnlyTrackSelected(pTrack);
 
+	// Make room for multichannel sources
+	if(channels > 2)
+	{
+		int nchan = min(64, channels + (channels & 1));
+		GetSetMediaTrackInfo(pTrack, "I_NCHAN", &nchan);
+	}
+
 	// Add new items to track
 	double pos = 0.0;
 	for(const SPlaylistEntry &e : filelist)
@@ -296,11 +387,17 @@ void PlaylistImport(COMMAND_T* ct)
 
 		GetSetMediaItemTakeInfo(pTake, "P_SOURCE", pSrc);
 		GetSetMediaItemTakeInfo(pTake, "P_NAME", (void*) e.title.c_str());
+
+		// Prefer the exact source length, playlist lengths are rounded to seconds
+		double length = pSrc->GetLength();
+		if(length <= 0.0)
+			length = e.length;
 		SetMediaItemPosition(pItem, pos, false);
-		SetMediaItemLength(pItem, e.length, false);
-		pos += e.length;
+		SetMediaItemLength(pItem, length, false);
+		pos += length;
 	}
 
+	PreventUIRefresh(-1);
 	Undo_EndBlock2(NULL, SWS_CMD_SHORTNAME(ct), UNDO_STATE_ITEMS|UNDO_STATE_TRACKCFG);
 
 	TrackList_AdjustWindows(false);
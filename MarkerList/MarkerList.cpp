@@ -219,7 +219,8 @@ SWS_MarkerListWnd::SWS_MarkerListWnd()
 	Init();
 }
 
-void SWS_MarkerListWnd::Update(bool bForce)
+// bRebuild: false to skip re-reading markers/regions unless the S&M tracker has reported changes
+void SWS_MarkerListWnd::Update(bool bForce, bool bRebuild)
 {
 	// Change the time string if the project time mode changes
 	static int prevTimeMode = -1;
@@ -242,8 +243,9 @@ void SWS_MarkerListWnd::Update(bool bForce)
 		g_curList = new MarkerList("CurrentList", true);
 		bChanged = true;
 	}
-	else if (g_curList->BuildFromReaper())
+	else if ((bRebuild || m_mkrRgnListener.m_bDirty) && g_curList->BuildFromReaper())
 		bChanged = true;
+	m_mkrRgnListener.m_bDirty = false;
 
 	if (m_pLists.GetSize() && bChanged)
 	{
@@ -277,6 +279,7 @@ void SWS_MarkerListWnd::OnInitDlg()
 	
 	Update();
 
+	RegisterToMarkerRegionUpdates(&m_mkrRgnListener);
 	SetTimer(m_hwnd, 1, 500, NULL);
 }
 
@@ -387,6 +390,7 @@ HMENU SWS_MarkerListWnd::OnContextMenu(int x, int y, bool* wantDefaultItems)
 void SWS_MarkerListWnd::OnDestroy()
 {
 	KillTimer(m_hwnd, 1);
+	UnregisterToMarkerRegionUpdates(&m_mkrRgnListener);
 	char cOptions[4];
 	sprintf(cOptions, "%c %c", m_bPlayOnSel ? '1' : '0', m_bScroll ? '1' : '0');
 	WritePrivateProfileString(SWS_INI, ML_OPTIONS_KEY, cOptions, get_ini_file());
@@ -395,7 +399,7 @@ void SWS_MarkerListWnd::OnDestroy()
 void SWS_MarkerListWnd::OnTimer(WPARAM wParam)
 {
 	if (ListView_GetSelectedCount(m_pLists.Get(0)->GetHWND()) <= 1 || !IsActive())
-		Update();
+		Update(false, false);
 }
 
 int SWS_MarkerListWnd::OnKey(MSG* msg, int iKeyState)
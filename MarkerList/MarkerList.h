@@ -28,8 +28,18 @@
 
 #pragma once
 
+#include "../SnM/SnM_Marker.h"
+
 class SWS_MarkerListWnd;
 
+class SWS_MarkerListListener : public SNM_MarkerRegionListener
+{
+public:
+	SWS_MarkerListListener() : SNM_MarkerRegionListener(), m_bDirty(true) {}
+	void NotifyMarkerRegionUpdate(int _updateFlags) { m_bDirty = true; }
+	bool m_bDirty;
+};
+
 class SWS_MarkerListView : public SWS_ListView
 {
 public:
@@ -53,7 +63,7 @@ class SWS_MarkerListWnd : public SWS_DockWnd
 {
 public:
 	SWS_MarkerListWnd();
-	void Update(bool bForce = false);
+	void Update(bool bForce = false, bool bRebuild = true);
 	double m_dCurPos;
 
 	WDL_String m_filter;
@@ -67,6 +77,8 @@ protected:
 	void OnDestroy();
 	void OnTimer(WPARAM wParam=0);
 	int OnKey(MSG* msg, int iKeyState);
+
+	SWS_MarkerListListener m_mkrRgnListener;
 };
 
 #define EXPORT_FORMAT_KEY "MarkerExport Format"
@@ -63,6 +63,16 @@ char* MarkerItem::ItemString(char* str, int iSize)
 	return str;
 }
 
+void MarkerItem::Set(bool bReg, double dPos, double dRegEnd, const char* cName, int num, int color)
+{
+	m_bReg = bReg;
+	m_dPos = dPos;
+	m_dRegEnd = bReg ? dRegEnd : -1.0;
+	m_num = num;
+	SetName(cName);
+	m_iColor = color;
+}
+
 bool MarkerItem::Compare(bool bReg, double dPos, double dRegEnd, const char* cName, int num, int color)
 {
 	return (bReg == m_bReg && dPos == m_dPos && num == m_num && (!bReg || dRegEnd == m_dRegEnd) && m_iColor == color && strcmp(cName, GetName()) == 0);
@@ -111,35 +121,57 @@ bool MarkerList::BuildFromReaper()
 {
 	SWS_SectionLock lock(&m_mutex);
 
-	// Instead of emptying and starting over, try to just add or delete for simple cases (added/deleted marker)
-	// markers moved in time are reallocated
+	// Instead of emptying and starting over, existing items are keyed by region flag + number
+	// and reused (or updated in place when edited/moved) so the list views keep their rows
 	// m_items maintains the same ordering as EnumProjectMarkers
+	std::multimap<int, MarkerItem*> oldItems;
+	for (int i = 0; i < m_items.GetSize(); i++)
+		oldItems.insert(std::make_pair(MarkerItem::MakeKey(m_items.Get(i)->IsRegion(), m_items.Get(i)->GetNum()), m_items.Get(i)));
+
 	int id, x = 0, i = 0, iColor = 0;
 	bool bR, bChanged = false;
 	double dPos, dRend;
 	const char *cName;
+	WDL_PtrList<MarkerItem> newItems;
 
 	while ((x=EnumMarkers(x, &bR, &dPos, &dRend, &cName, &id, &iColor)))
 	{
-		if (i >= m_items.GetSize() || !m_items.Get(i)->Compare(bR, dPos, dRend, cName ? cName : "", id, iColor))
-		{ // not found, try ahead one more
-			if (i+1 >= m_items.GetSize() || !m_items.Get(i+1)->Compare(bR, dPos, dRend, cName, id, iColor))
-			{	// not found one ahead, assume new and insert at current position
-				m_items.Insert(i, new MarkerItem(bR, dPos, dRend, cName, id, iColor));
-				bChanged = true;
-			}
-			else
-			{	// found one ahead, the current one must have been deleted
-				m_items.Delete(i, true);
+		if (!cName) cName = "";
+		MarkerItem* mi = NULL;
+		std::multimap<int, MarkerItem*>::iterator it = oldItems.find(MarkerItem::MakeKey(bR, id));
+		if (it != oldItems.end())
+		{
+			mi = it->second;
+			oldItems.erase(it);
+			if (!mi->Compare(bR, dPos, dRend, cName, id, iColor))
+			{
+				mi->Set(bR, dPos, dRend, cName, id, iColor);
 				bChanged = true;
 			}
 		}
+		else
+		{
+			mi = new MarkerItem(bR, dPos, dRend, cName, id, iColor);
+			bChanged = true;
+		}
+		if (!bChanged && m_items.Get(i) != mi)
+			bChanged = true; // re-ordered
+		newItems.Add(mi);
 		i++;
 	}
-	while(i < m_items.GetSize())
+
+	// Whatever is left has been deleted
+	for (std::multimap<int, MarkerItem*>::iterator it = oldItems.begin(); it != oldItems.end(); ++it)
 	{
+		delete it->second;
 		bChanged = true;
-		m_items.Delete(i, true);
+	}
+
+	if (bChanged)
+	{
+		m_items.Empty(false);
+		for (i = 0; i < newItems.GetSize(); i++)
+			m_items.Add(newItems.Get(i));
 	}
 
 	return bChanged;
@@ -35,6 +35,7 @@ public:
 	~MarkerItem() {}
 	char* ItemString(char* str, int iSize);
 	void SetFromString(LineParser* lp);
+	void Set(bool bReg, double dPos, double dRegEnd, const char* cName, int id, int color);
 	bool Compare(bool bReg, double dPos, double dRegEnd, const char* cName, int id, int color);
 	bool Compare(MarkerItem* mi);
 	void AddToProject();
@@ -53,6 +54,7 @@ public:
 	void SetNum(int num) { m_num = num; }
 	int GetColor() { return m_iColor; }
 	void SetColor(int iColor) { m_iColor = iColor; }
+	static int MakeKey(bool bReg, int num) { return (num << 1) | (bReg ? 1 : 0); }
 
 protected:
 	WDL_String m_name;
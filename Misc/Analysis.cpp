@@ -32,6 +32,28 @@
 
 static void GetRMSOptions(double *target, double *windowSize);
 
+// Momentary and short-term loudness are measured every 100 ms, independently of the analysis block size
+static void AddLoudnessFrames(ANALYZE_PCM* a, ReaSample* samples, int frames, int nch, double samplerate)
+{
+	const int step = max((int)(samplerate / 10), 1);
+	for (int i = 0; i < frames; i += step)
+	{
+		const int n = min(step, frames - i);
+#if REASAMPLE_SIZE == 4
+		ebur128_add_frames_float(a->loudness, samples + i * nch, n);
+#else
+		ebur128_add_frames_double(a->loudness, samples + i * nch, n);
+#endif
+
+		const double time = (double)(a->sampleCount + i + n) / samplerate;
+		double loudness;
+		if (time >= 0.4 && (a->loudness->mode & EBUR128_MODE_M) == EBUR128_MODE_M && ebur128_loudness_momentary(a->loudness, &loudness) == EBUR128_SUCCESS && loudness > a->dMomentaryMax)
+			a->dMomentaryMax = loudness;
+		if (time >= 3.0 && (a->loudness->mode & EBUR128_MODE_S) == EBUR128_MODE_S && ebur128_loudness_shortterm(a->loudness, &loudness) == EBUR128_SUCCESS && loudness > a->dShortTermMax)
+			a->dShortTermMax = loudness;
+	}
+}
+
 static bool AnalyzePCMSource(ANALYZE_PCM* a)
 {
 	// Init local transfer block "t" and sum of squares
@@ -58,6 +80,15 @@ static bool AnalyzePCMSource(ANALYZE_PCM* a)
 	for (int i = 0; i < t.nch; i++)
 		dSumSquares[i] = 0.0;
 
+	// In windowed mode dSumSquares only covers the current window, keep separate sums for the entire item
+	double* dTotalSquares = dSumSquares;
+	if (a->dWindowSize != 0.0)
+	{
+		dTotalSquares = new double[t.nch];
+		for (int i = 0; i < t.nch; i++)
+			dTotalSquares[i] = 0.0;
+	}
+
 	// Init output variables.  Note can have different channel count.
 	for (int i = 0; i < a->iChannels; i++)
 	{
@@ -65,9 +96,13 @@ static bool AnalyzePCMSource(ANALYZE_PCM* a)
 		if (a->dRMSs) a->dRMSs[i] = 0.0;
 		if (a->peakSamples) a->peakSamples[i] = 0;
 		if (a->peakRMSsamples) a->peakRMSsamples[i] = -666;
+		if (a->dAvgRMSs) a->dAvgRMSs[i] = 0.0;
 	}
 	a->dPeakVal = 0.0;
 	a->dRMS = 0.0;
+	a->dAvgRMS = 0.0;
+	a->dMomentaryMax = -HUGE_VAL;
+	a->dShortTermMax = -HUGE_VAL;
 	a->peakRMSsample = -666;
 	a->peakSample = 0;
 	a->dProgress = 0.0;
@@ -79,12 +114,17 @@ static bool AnalyzePCMSource(ANALYZE_PCM* a)
 	a->pcm->GetSamples(&t);
 	while (t.samples_out)
 	{
+		if (a->loudness)
+			AddLoudnessFrames(a, t.samples, t.samples_out, t.nch, t.samplerate);
+
 		for (int samp = 0; samp < t.samples_out; samp++)
 		{
 			for (int chan = 0; chan < t.nch; chan++)
 			{
 				int i = samp*t.nch + chan;
 				dSumSquares[chan] += t.samples[i] * t.samples[i];
+				if (dTotalSquares != dSumSquares)
+					dTotalSquares[chan] += t.samples[i] * t.samples[i];
 				double absamp = fabs(t.samples[i]);
 				if (absamp > a->dPeakVal)
 				{
@@ -162,8 +202,22 @@ static bool AnalyzePCMSource(ANALYZE_PCM* a)
 
 	}
 
+	// RMS over the entire item, same as non-windowed mode's RMS
+	if (a->dAvgRMSs && a->sampleCount)
+		for (int i = 0; i < a->iChannels && i < t.nch; i++)
+			a->dAvgRMSs[i] = sqrt(dTotalSquares[i] / a->sampleCount);
+	if (a->sampleCount)
+	{
+		double dSS = 0.0;
+		for (int i = 0; i < t.nch; i++)
+			dSS += dTotalSquares[i];
+		a->dAvgRMS = sqrt(dSS / (a->sampleCount * t.nch));
+	}
+
 	delete[] t.samples;
 	delete[] prevBuf;
+	if (dTotalSquares != dSumSquares)
+		delete[] dTotalSquares;
 	delete[] dSumSquares;
 
 	return true;
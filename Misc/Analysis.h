@@ -27,6 +27,8 @@
 
 #pragma once
 
+#include "../libebur128/ebur128.h"
+
 #define SWS_RMS_KEY "RMS normalize params"
 
 // Data passing to/from the Analyze functions.
@@ -46,6 +48,11 @@ typedef struct ANALYZE_PCM
 	double dProgress;       // out Analysis progress, 0.0-1.0 for 0-100%
 	INT64 sampleCount;      // out # of samples analyzed
 	double dWindowSize;     // RMS window in seconds.  If this is != 0.0, then RMS is calculated/returned as max within window
+	double* dAvgRMSs;       // i/o Array of channel RMS values over the entire item, also calculated in windowed mode (optional)
+	double dAvgRMS;         // out RMS of all channels over the entire item, also calculated in windowed mode
+	ebur128_state* loudness; // in Analyzed samples are also added to this EBU R128 state (optional)
+	double dMomentaryMax;   // out Max. momentary loudness, if loudness was initialized with EBUR128_MODE_M
+	double dShortTermMax;   // out Max. short-term loudness, if loudness was initialized with EBUR128_MODE_S
 	bool success;
 } ANALYZE_PCM;
 
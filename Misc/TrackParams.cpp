@@ -32,36 +32,30 @@
 #include "TrackSel.h"
 #include "../reaper/localize.h"
 
-void EnableMPSend(COMMAND_T* = NULL)
+// Sets a track param on all selected tracks (+ master if bMaster) in one transaction
+static bool SetSelTracksParam(const char* parm, double val, bool bMaster = false)
 {
-	for (int i = 1; i <= GetNumTracks(); i++)
-	{
-		MediaTrack* tr = CSurf_TrackFromID(i, false);
-		if (*(int*)GetSetMediaTrackInfo(tr, "I_SELECTED", NULL))
-			GetSetMediaTrackInfo(tr, "B_MAINSEND", &g_bTrue);
-	}
-}
-void DisableMPSend(COMMAND_T* = NULL)
-{
-	for (int i = 1; i <= GetNumTracks(); i++)
+	SWS_TrackTransaction trans;
+	for (int i = bMaster ? 0 : 1; i <= GetNumTracks(); i++)
 	{
 		MediaTrack* tr = CSurf_TrackFromID(i, false);
 		if (*(int*)GetSetMediaTrackInfo(tr, "I_SELECTED", NULL))
-			GetSetMediaTrackInfo(tr, "B_MAINSEND", &g_bFalse);
+			trans.Set(tr, parm, val);
 	}
+	return trans.Commit();
 }
 
+void EnableMPSend(COMMAND_T* = NULL)	{ SetSelTracksParam("B_MAINSEND", 1.0); }
+void DisableMPSend(COMMAND_T* = NULL)	{ SetSelTracksParam("B_MAINSEND", 0.0); }
+
 void TogMPSend(COMMAND_T* = NULL)
 {
-	bool bMPSend;
+	SWS_TrackTransaction trans;
 	for (int i = 1; i <= GetNumTracks(); i++)
 	{
 		MediaTrack* tr = CSurf_TrackFromID(i, false);
 		if (*(int*)GetSetMediaTrackInfo(tr, "I_SELECTED", NULL))
-		{
-			bMPSend = !*(bool*)GetSetMediaTrackInfo(tr, "B_MAINSEND", NULL);
-			GetSetMediaTrackInfo(tr, "B_MAINSEND", &bMPSend);
-		}
+			trans.Set(tr, "B_MAINSEND", *(bool*)GetSetMediaTrackInfo(tr, "B_MAINSEND", NULL) ? 0.0 : 1.0);
 	}
 }
 
@@ -199,25 +193,8 @@ void UnmuteSends(COMMAND_T* = NULL)
 	}
 }
 
-void BypassFX(COMMAND_T* = NULL)
-{
-	for (int i = 0; i <= GetNumTracks(); i++)
-	{
-		MediaTrack* tr = CSurf_TrackFromID(i, false);
-		if (*(int*)GetSetMediaTrackInfo(tr, "I_SELECTED", NULL))
-			GetSetMediaTrackInfo(tr, "I_FXEN", &g_i0);
-	}
-}
-
-void UnbypassFX(COMMAND_T* = NULL)
-{
-	for (int i = 0; i <= GetNumTracks(); i++)
-	{
-		MediaTrack* tr = CSurf_TrackFromID(i, false);
-		if (*(int*)GetSetMediaTrackInfo(tr, "I_SELECTED", NULL))
-			GetSetMediaTrackInfo(tr, "I_FXEN", &g_i1);
-	}
-}
+void BypassFX(COMMAND_T* = NULL)	{ SetSelTracksParam("I_FXEN", 0.0, true); }
+void UnbypassFX(COMMAND_T* = NULL)	{ SetSelTracksParam("I_FXEN", 1.0, true); }
 
 static int g_iMasterFXEn = 1;
 void SaveMasterFXEn(COMMAND_T*)  { g_iMasterFXEn = *(int*)GetSetMediaTrackInfo(CSurf_TrackFromID(0, false), "I_FXEN", NULL); }
@@ -227,14 +204,7 @@ void DisableMasterFX(COMMAND_T*) { GetSetMediaTrackInfo(CSurf_TrackFromID(0, fal
 
 void MinimizeTracks(COMMAND_T* = NULL)
 {
-	for (int i = 0; i <= GetNumTracks(); i++)
-	{
-		MediaTrack* tr = CSurf_TrackFromID(i, false);
-		if (*(int*)GetSetMediaTrackInfo(tr, "I_SELECTED", NULL))
-			GetSetMediaTrackInfo(tr, "I_HEIGHTOVERRIDE", &g_i1);
-	}
-	TrackList_AdjustWindows(false);
-	UpdateTimeline();
+	SetSelTracksParam("I_HEIGHTOVERRIDE", 1.0, true);
 }
 
 int IsMinimizeTracks(COMMAND_T* ct)
@@ -280,25 +250,8 @@ void RecSrcOut(COMMAND_T* = NULL)
 	}
 }
 
-void SetMonMedia(COMMAND_T* = NULL)
-{
-	for (int i = 1; i <= GetNumTracks(); i++)
-	{
-		MediaTrack* tr = CSurf_TrackFromID(i, false);
-		if (*(int*)GetSetMediaTrackInfo(tr, "I_SELECTED", NULL))
-			GetSetMediaTrackInfo(tr, "I_RECMONITEMS", &g_i1);
-	}
-}
-
-void UnsetMonMedia(COMMAND_T* = NULL)
-{
-	for (int i = 1; i <= GetNumTracks(); i++)
-	{
-		MediaTrack* tr = CSurf_TrackFromID(i, false);
-		if (*(int*)GetSetMediaTrackInfo(tr, "I_SELECTED", NULL))
-			GetSetMediaTrackInfo(tr, "I_RECMONITEMS", &g_i0);
-	}
-}
+void SetMonMedia(COMMAND_T* = NULL)	{ SetSelTracksParam("I_RECMONITEMS", 1.0); }
+void UnsetMonMedia(COMMAND_T* = NULL)	{ SetSelTracksParam("I_RECMONITEMS", 0.0); }
 
 void InsertTrkAbove(COMMAND_T* = NULL)
 {
@@ -448,6 +401,7 @@ int CheckTrackParam(COMMAND_T* ct)
 
 void ToolbarToggle(COMMAND_T* ct, WDL_TypedBuf<TrackInfo>* pState)
 {
+	SWS_TrackTransaction trans;
 	if (CheckTrackParam(ct))
 	{
 		pState->Resize(GetNumTracks(), false);
@@ -456,18 +410,25 @@ void ToolbarToggle(COMMAND_T* ct, WDL_TypedBuf<TrackInfo>* pState)
 			MediaTrack* tr = CSurf_TrackFromID(i, false);
 			pState->Get()[i-1].guid = *(GUID*)GetSetMediaTrackInfo(tr, "GUID", NULL);
 			pState->Get()[i-1].param = GetMediaTrackInfo_Value(tr, (const char*)ct->user);
-			SetMediaTrackInfo_Value(tr, (const char*)ct->user, 0.0);
+			trans.Set(tr, (const char*)ct->user, 0.0);
 		}
 	}
 	else
-	{	// Restore state
+	{	// Restore state, GUIDs are looked up once rather than per saved track
+		std::map<GUID, MediaTrack*, GUIDLess> tracks;
+		for (int i = 1; i <= GetNumTracks(); i++)
+		{
+			MediaTrack* tr = CSurf_TrackFromID(i, false);
+			tracks[*(GUID*)GetSetMediaTrackInfo(tr, "GUID", NULL)] = tr;
+		}
 		for (int i = 0; i < pState->GetSize(); i++)
 		{
-			MediaTrack* tr = GuidToTrack(&pState->Get()[i].guid);
-			if (tr)
-				SetMediaTrackInfo_Value(tr, (const char*)ct->user, pState->Get()[i].param);
+			std::map<GUID, MediaTrack*, GUIDLess>::iterator it = tracks.find(pState->Get()[i].guid);
+			if (it != tracks.end())
+				trans.Set(it->second, (const char*)ct->user, pState->Get()[i].param);
 		}
 	}
+	trans.Commit();
 	TrackList_AdjustWindows(false);
 	Undo_OnStateChangeEx(SWS_CMD_SHORTNAME(ct), UNDO_STATE_TRACKCFG, -1);
 }
@@ -493,6 +454,7 @@ void MuteToggle(COMMAND_T* ct)
 void InputMatch(COMMAND_T* ct)
 {
 	int iInput = -2; // Would use -1, but that's for "Input: None"
+	SWS_TrackTransaction trans;
 	for (int i = 1; i <= GetNumTracks(); i++)
 	{
 		MediaTrack* tr = CSurf_TrackFromID(i, false);
@@ -501,9 +463,10 @@ void InputMatch(COMMAND_T* ct)
 			if (iInput == -2)
 				iInput = *(int*)GetSetMediaTrackInfo(tr, "I_RECINPUT", NULL);
 			else
-				GetSetMediaTrackInfo(tr, "I_RECINPUT", &iInput);
+				trans.Set(tr, "I_RECINPUT", (double)iInput);
 		}
 	}
+	trans.Commit();
 	TrackList_AdjustWindows(false);
 	Undo_OnStateChangeEx(SWS_CMD_SHORTNAME(ct), UNDO_STATE_TRACKCFG, -1);
 }
@@ -70,6 +70,13 @@ LfoWaveParams& LfoWaveParams::operator=(const LfoWaveParams &params)
 	return *this;
 }
 
+// Envelope LFO max. error (relative to the LFO amplitude) for a sampling precision
+// (fraction of a cycle): the default 0.05 gives 2%, i.e. sine peaks with slow start/end
+static double LfoTolerance(double dPrecision)
+{
+	return 0.4*dPrecision;
+}
+
 EnvLfoParams::EnvLfoParams()
 : waveParams(), precision(0.05), midiCc(7), takeEnvType(eTAKEENV_VOLUME), envType(eENVTYPE_TRACK), timeSegment(eTIMESEGMENT_TIMESEL), activeTakeOnly(true)
 , freqModulator()
@@ -171,58 +178,51 @@ EnvelopeProcessor::ErrorCode EnvelopeProcessor::getTrackEnvelopeMinMax(TrackEnve
 	if(!envelope)
 		return eERRORCODE_NOENVELOPE;
 
-	char* envState = GetSetObjectState(envelope, "");
-	if(!envState)
+	// Only the first line of the chunk is needed, REAPER truncates the chunk to the buffer size
+	// so there's no need to get the whole chunk (can be huge with lots of points)
+	char envState[256];
+	if(!GetEnvelopeStateChunk(envelope, envState, sizeof(envState), false))
 		return eERRORCODE_NOOBJSTATE;
+	envState[sizeof(envState)-1] = '\0';
 
 	dEnvMinVal = 0.0;
 	dEnvMaxVal = 1.0;
 	double dTmp[2];
 	int iTmp;
 
-	stringstream envStateStream;
-	envStateStream << envState;
-	std::vector<string> tokens;
-	while(!envStateStream.eof())
-	{
-		string str;
-		getline(envStateStream, str, '\n');
-		tokens.push_back(str);
-	}
-
-	for(vector<string>::const_iterator it = tokens.begin(); it !=tokens.end(); ++it)
+	envelope::LineIterator lines(envState);
+	while(char* token = lines.next())
 	{
 		// Track envelope: Volume
-		if(!strcmp(it->c_str(), "<VOLENV") || !strcmp(it->c_str(), "<VOLENV2"))
+		if(!strcmp(token, "<VOLENV") || !strcmp(token, "<VOLENV2"))
 		{
 			dEnvMaxVal = 2.0;
 			break;
 		}
 
 		// Track envelope: Pan
-		if(!strcmp(it->c_str(), "<PANENV") || !strcmp(it->c_str(), "<PANENV2"))
+		if(!strcmp(token, "<PANENV") || !strcmp(token, "<PANENV2"))
 		{
 			dEnvMinVal = -1.0;
 			break;
 		}
 
 		// Track envelope: Param (VST index, min value, max value)
-		if(sscanf(it->c_str(), "<PARMENV %d %lf %lf", &iTmp, &dTmp[0], &dTmp[1]) == 3)
+		if(sscanf(token, "<PARMENV %d %lf %lf", &iTmp, &dTmp[0], &dTmp[1]) == 3)
 		{
 			dEnvMinVal = dTmp[0];
 			dEnvMaxVal = dTmp[1];
 			break;
 		}
 
-		if(!strcmp(it->c_str(), ">"))
+		if(!strcmp(token, ">"))
 			break;
 	}
 
-	FreeHeapPtr(envState);
 	return eERRORCODE_OK;
 }
 
-void EnvelopeProcessor::writeLfoPoints(MediaItem_Take* take, string &envState, double dStartTime, double dEndTime, double dValMin, double dValMax, LfoWaveParams &waveParams, double dPrecision, LfoWaveParams* freqModulator)
+void EnvelopeProcessor::writeLfoPoints(MediaItem_Take* take, vector<LfoPoint> &points, double dStartTime, double dEndTime, double dValMin, double dValMax, LfoWaveParams &waveParams, double dTolerance)
 {
 	double dFreq, dDelay;
 	getFreqDelay(waveParams, dFreq, dDelay);
@@ -235,7 +235,6 @@ void EnvelopeProcessor::writeLfoPoints(MediaItem_Take* take, string &envState, d
 	double dScale = dValMax - dOff;
 	double dSamplerate;
 	double dValue = 0.0;
-	char buffer[BUFFER_SIZE];
 
 	EnvShape tEnvShape = eENVSHAPE_LINEAR;
 	switch(waveParams.shape)
@@ -252,6 +251,9 @@ void EnvelopeProcessor::writeLfoPoints(MediaItem_Take* take, string &envState, d
 		break;
 
 		case eWAVSHAPE_SINE :
+			// see below
+		break;
+
 		case eWAVSHAPE_TRIANGLE_BEZIER :
 		case eWAVSHAPE_RANDOM_BEZIER :
 		case eWAVSHAPE_SAWUP_BEZIER :
@@ -273,13 +275,29 @@ void EnvelopeProcessor::writeLfoPoints(MediaItem_Take* take, string &envState, d
 	bool bFlipFlop;
 	double dFlipFlop;
 	double dLength = dEndTime - dStartTime;
+	int iSineSteps = 1;
 
 	switch(waveParams.shape)
 	{
 		case eWAVSHAPE_SINE :
-			dSamplerate = dPrecision/dFreq;
+		{
+			// Sine is written from peak to peak. Slow start/end shape (x^2*(3-2x)) stays within 1% of the
+			// peak to peak range of a half cycle, when asked for better than that, split half cycles into
+			// linear segments: max. error of a segment spanning h radians is 1-cos(h/2)
+			if(dTolerance >= 0.02)
+			{
+				tEnvShape = eENVSHAPE_SLOW;
+			}
+			else
+			{
+				tEnvShape = eENVSHAPE_LINEAR;
+				double dSegment = 2.0*acos(1.0 - max(dTolerance, 0.0001));
+				iSineSteps = (int)ceil(PI/dSegment);
+			}
+			dSamplerate = 0.5/dFreq/iSineSteps;
 			dCarrierStart = WaveformGeneratorSin(0.0, dFreq, dDelaySec);
 			dCarrierEnd = WaveformGeneratorSin(dLength, dFreq, dDelaySec);
+		}
 		break;
 
 		case eWAVSHAPE_TRIANGLE :
@@ -330,36 +348,57 @@ void EnvelopeProcessor::writeLfoPoints(MediaItem_Take* take, string &envState, d
 	double dValueEnd = waveParams.offset + dMagnitude*dCarrierEnd;
 	dValueEnd = dScale*dValueEnd + dOff;
 
-	sprintf(buffer, "PT %lf %lf %d\n", dStartTime, dValueStart, tEnvShape);
-	envState.append(buffer);
+	// Number of points is known up front (+1 for the first partial period, +2 for start/end points)
+	const int iMaxPoints = (int)(dLength/dSamplerate) + 3;
+	points.reserve(points.size() + 2*iMaxPoints);
 
-//double dFreqMod = dFreq;
-//freqModulator = new LfoWaveParams();
-//freqModulator->freqHz = dFreq/100.0;
-//freqModulator->strength = 0.6;
+	LfoPoint point = {dStartTime, dValueStart, tEnvShape};
+	points.push_back(point);
 
 	switch(waveParams.shape)
 	{
 		case eWAVSHAPE_SINE :
 		{
-			for(double t = -dDelaySec; t<dLength; t += dSamplerate)
+			// Points are aligned to peaks (phase 1/4) so peaks always get a point, partial half cycles
+			// at both ends are split into linear segments since slow start/end only fits peak to peak
+			double dEdgeStep = acos(1.0 - min(max(dTolerance, 0.0001), 1.0))/PI/dFreq;
+			double dFirstPoint = 0.25/dFreq - dDelaySec;
+			dFirstPoint -= floor(dFirstPoint/dSamplerate)*dSamplerate;
+			if(dFirstPoint <= 0.0)
+				dFirstPoint += dSamplerate;
+
+			if(tEnvShape != eENVSHAPE_LINEAR)
 			{
-				if(t>0.0)
+				points.back().shape = eENVSHAPE_LINEAR;
+				for(double t = dEdgeStep; t < min(dFirstPoint, dLength); t += dEdgeStep)
 				{
-//if(freqModulator)
-//{
-//	double dFreqCarrier = WaveformGeneratorSawUp(t, freqModulator->freqHz, 1000.0*freqModulator->delayMsec);
-//	dFreqMod = dFreq*(1.0 + freqModulator->strength * dFreqCarrier);
-//	// Watch out for NaNs !!!
-////	dSamplerate = dPrecision/dFreqMod;
-//	dSamplerate = 0.01;
-//}
+					dValue = waveParams.offset + dMagnitude*WaveformGeneratorSin(t, dFreq, dDelaySec);
+					LfoPoint edge = {t+dStartTime, dScale*dValue + dOff, eENVSHAPE_LINEAR};
+					points.push_back(edge);
+				}
+			}
 
+			double dLastPoint = dFirstPoint;
+			for(int i = 0; ; ++i)
+			{
+				double t = dFirstPoint + i*dSamplerate;
+				if(t >= dLength)
+					break;
+
+				dValue = waveParams.offset + dMagnitude*WaveformGeneratorSin(t, dFreq, dDelaySec);
+				LfoPoint peak = {t+dStartTime, dScale*dValue + dOff, tEnvShape};
+				points.push_back(peak);
+				dLastPoint = t;
+			}
+
+			if(tEnvShape != eENVSHAPE_LINEAR && dLastPoint < dLength)
+			{
+				points.back().shape = eENVSHAPE_LINEAR;
+				for(double t = dLastPoint + dEdgeStep; t < dLength; t += dEdgeStep)
+				{
 					dValue = waveParams.offset + dMagnitude*WaveformGeneratorSin(t, dFreq, dDelaySec);
-//dValue = waveParams.offset + dMagnitude*WaveformGeneratorSin(t, dFreqMod, dDelaySec);
-					dValue = dScale*dValue + dOff;
-					sprintf(buffer, "PT %lf %lf %d\n", t+dStartTime, dValue, tEnvShape);
-					envState.append(buffer);
+					LfoPoint edge = {t+dStartTime, dScale*dValue + dOff, eENVSHAPE_LINEAR};
+					points.push_back(edge);
 				}
 			}
 		}
@@ -369,17 +408,13 @@ void EnvelopeProcessor::writeLfoPoints(MediaItem_Take* take, string &envState, d
 		case eWAVSHAPE_TRIANGLE_BEZIER :
 		case eWAVSHAPE_SQUARE :
 		{
-			//for(double t = dStartTime-dDelaySec; t < dEndTime; t += dSamplerate)
 			for(double t = -dDelaySec; t<dLength; t += dSamplerate)
 			{
-				//if(t<=dStartTime)
-					//continue;
 				if(t>0.0)
 				{
 					dValue = waveParams.offset + dMagnitude*dFlipFlop;
-					dValue = dScale*dValue + dOff;
-					sprintf(buffer, "PT %lf %lf %d\n", t+dStartTime, dValue, tEnvShape);
-					envState.append(buffer);
+					LfoPoint flip = {t+dStartTime, dScale*dValue + dOff, tEnvShape};
+					points.push_back(flip);
 					dFlipFlop = -dFlipFlop;
 				}
 			}
@@ -398,9 +433,8 @@ void EnvelopeProcessor::writeLfoPoints(MediaItem_Take* take, string &envState, d
 					for(int i=0; i<2; i++)
 					{
 						dValue = waveParams.offset + dMagnitude*dFlipFlop;
-						dValue = dScale*dValue + dOff;
-						sprintf(buffer, "PT %lf %lf %d\n", t+dStartTime, dValue, tEnvShape);
-						envState.append(buffer);
+						LfoPoint edge = {t+dStartTime, dScale*dValue + dOff, tEnvShape};
+						points.push_back(edge);
 						dFlipFlop = -dFlipFlop;
 					}
 				}
@@ -422,9 +456,8 @@ void EnvelopeProcessor::writeLfoPoints(MediaItem_Take* take, string &envState, d
 				if(t>0.0)
 				{
 					dValue = waveParams.offset + dMagnitude*WaveformGeneratorRandom(t, dFreq, dDelaySec);
-					dValue = dScale*dValue + dOff;
-					sprintf(buffer, "PT %lf %lf %d\n", t+dStartTime, dValue, tEnvShape);
-					envState.append(buffer);
+					LfoPoint random = {t+dStartTime, dScale*dValue + dOff, tEnvShape};
+					points.push_back(random);
 				}
 			}
 		}
@@ -434,8 +467,19 @@ void EnvelopeProcessor::writeLfoPoints(MediaItem_Take* take, string &envState, d
 		break;
 	}
 
-	sprintf(buffer, "PT %lf %lf %d\n", dEndTime, dValueEnd, tEnvShape);
-	envState.append(buffer);
+	point.position = dEndTime;
+	point.value = dValueEnd;
+	points.push_back(point);
+}
+
+void EnvelopeProcessor::insertLfoPoints(TrackEnvelope* envelope, const vector<LfoPoint> &points, double dStartTime, double dEndTime)
+{
+	// Inserting through the API (without sorting after each point) is much cheaper than
+	// getting and setting the whole chunk for envelopes with lots of points
+	DeleteEnvelopePointRange(envelope, dStartTime, dEndTime);
+	for(vector<LfoPoint>::const_iterator it = points.begin(); it != points.end(); ++it)
+		InsertEnvelopePoint(envelope, it->position, it->value, it->shape, 0.0, false, &g_bTrue);
+	Envelope_SortPoints(envelope);
 }
 
 EnvelopeProcessor::ErrorCode EnvelopeProcessor::processPoints(char* envState, string &newState, double dStartPos, double dEndPos, double dValMin, double dValMax, EnvModType envModType, double dStrength, double dOffset)
@@ -460,7 +504,8 @@ EnvelopeProcessor::ErrorCode EnvelopeProcessor::processPoints(char* envState, st
 
 	double position, value;
 	int iTmp;
-	char* token = strtok(envState, "\n");
+	envelope::LineIterator lines(envState);
+	char* token = lines.next();
 
 	while(token != NULL)
 	{
@@ -529,7 +574,7 @@ EnvelopeProcessor::ErrorCode EnvelopeProcessor::processPoints(char* envState, st
 				newState.append(newLine);
 				newState.append("\n");
 
-				token = strtok(NULL, "\n");
+				token = lines.next();
 				continue;
 			}
 		}
@@ -539,18 +584,16 @@ EnvelopeProcessor::ErrorCode EnvelopeProcessor::processPoints(char* envState, st
 
 		newState.append(token);
 		newState.append("\n");
-		token = strtok(NULL, "\n");
+		token = lines.next();
 	}
 
-	newState.append(token);
-	newState.append("\n");
-	token = strtok(NULL, "\n");
-	while(token != NULL)
+	if(token)
 	{
 		newState.append(token);
 		newState.append("\n");
-		token = strtok(NULL, "\n");
 	}
+	if(const char* rest = lines.rest())
+		newState.append(rest);
 
 //	FreeHeapPtr(envState);
 //
@@ -561,7 +604,7 @@ EnvelopeProcessor::ErrorCode EnvelopeProcessor::processPoints(char* envState, st
 	return eERRORCODE_OK;
 }
 
-EnvelopeProcessor::ErrorCode EnvelopeProcessor::generateTrackLfo(TrackEnvelope* envelope, double dStartPos, double dEndPos, LfoWaveParams &waveParams, double dPrecision)
+EnvelopeProcessor::ErrorCode EnvelopeProcessor::generateTrackLfo(TrackEnvelope* envelope, double dStartPos, double dEndPos, LfoWaveParams &waveParams, double dTolerance)
 {
 	if(!envelope)
 		return eERRORCODE_NOENVELOPE;
@@ -569,69 +612,14 @@ EnvelopeProcessor::ErrorCode EnvelopeProcessor::generateTrackLfo(TrackEnvelope*
 	if(dStartPos==dEndPos)
 		return eERRORCODE_NULLTIMESELECTION;
 
-	char* envState = GetSetObjectState(envelope, "");
-	if(!envState)
-		return eERRORCODE_NOOBJSTATE;
-
-	string newState;
-	double dValMin = 0.0;
-	double dValMax = 1.0;
-	double dTmp[2];
-	int iTmp;
-
-	//! \todo Use with GetMinMax()
-	char* token = strtok(envState, "\n");
-	while(token != NULL)
-	{
-		if(!strcmp(token, "<VOLENV") || !strcmp(token, "<VOLENV2"))
-			dValMax = 2.0;
-
-		if(!strcmp(token, "<PANENV") || !strcmp(token, "<PANENV2"))
-			dValMin = -1.0;
-
-		// VST index, min value, max value
-		if(sscanf(token, "<PARMENV %d %lf %lf", &iTmp, &dTmp[0], &dTmp[1]) == 3)
-		{
-			dValMin = dTmp[0];
-			dValMax = dTmp[1];
-		}
-
-		// Position, value, shape
-		if(sscanf(token, "PT %lf %lf %d\n", &dTmp[0], &dTmp[1], &iTmp) == 3)
-		{
-			if(dTmp[0]>=dEndPos)
-				break;
-			if(dTmp[0]>dStartPos)
-			{
-				token = strtok(NULL, "\n");
-				continue;
-			}
-		}
-
-		if(!strcmp(token, ">"))
-			break;
-
-		newState.append(token);
-		newState.append("\n");
-		token = strtok(NULL, "\n");
-	}
-
-	writeLfoPoints(nullptr, newState, dStartPos, dEndPos, dValMin, dValMax, waveParams, dPrecision);
-
-	newState.append(token);
-	newState.append("\n");
-	token = strtok(NULL, "\n");
-	while(token != NULL)
-	{
-		newState.append(token);
-		newState.append("\n");
-		token = strtok(NULL, "\n");
-	}
-
-	FreeHeapPtr(envState);
+	double dValMin, dValMax;
+	ErrorCode res = getTrackEnvelopeMinMax(envelope, dValMin, dValMax);
+	if(res != eERRORCODE_OK)
+		return res;
 
-	if(GetSetObjectState(envelope, newState.c_str()))
-		return eERRORCODE_UNKNOWN;
+	vector<LfoPoint> points;
+	writeLfoPoints(nullptr, points, dStartPos, dEndPos, dValMin, dValMax, waveParams, dTolerance);
+	insertLfoPoints(envelope, points, dStartPos, dEndPos);
 
 /* JFB commented: leads to "recursive" undo point, enabled at top level
 	Undo_OnStateChangeEx("Track Envelope LFO", UNDO_STATE_ALL, -1);
@@ -671,14 +659,14 @@ EnvelopeProcessor::ErrorCode EnvelopeProcessor::generateSelectedTrackEnvLfo()
 	//Main_OnCommandEx(ID_MOVE_TIMESEL_NUDGE_RIGHTEDGE_LEFT, 0, 0);
 	//Main_OnCommandEx(ID_ENVELOPE_DELETE_ALL_POINTS_TIMESEL, 0, 0);
 
-	ErrorCode res = generateTrackLfo(envelope, dStartPos, dEndPos, _parameters.waveParams, _parameters.precision);
+	ErrorCode res = generateTrackLfo(envelope, dStartPos, dEndPos, _parameters.waveParams, LfoTolerance(_parameters.precision));
 //UpdateTimeline();
 
 	Undo_EndBlock2(NULL, __LOCALIZE("Track envelope LFO","sws_undo"), UNDO_STATE_TRACKCFG);
 	return res;
 }
 
-EnvelopeProcessor::ErrorCode EnvelopeProcessor::generateTakeLfo(MediaItem_Take* take, double dStartPos, double dEndPos, TakeEnvType tTakeEnvType, LfoWaveParams &waveParams, double dPrecision)
+EnvelopeProcessor::ErrorCode EnvelopeProcessor::generateTakeLfo(MediaItem_Take* take, double dStartPos, double dEndPos, TakeEnvType tTakeEnvType, LfoWaveParams &waveParams, double dTolerance)
 {
 	double dValMin = 0.0;
 	double dValMax = 1.0;
@@ -715,92 +703,9 @@ EnvelopeProcessor::ErrorCode EnvelopeProcessor::generateTakeLfo(MediaItem_Take*
 	//if(dStartPos==dEndPos)
 	//	return eERRORCODE_NULLTIMESELECTION;
 
-	string newState;
-	string envStateStr;
-	try {
-		envStateStr = envelope::GetEnvelopeStateChunkBig(envelope);
-	}
-	catch (const envelope::bad_get_env_chunk_big &) {
-		return eERRORCODE_NOOBJSTATE;
-	}
-	
-	char* envState = &envStateStr[0];
-	double dTmp[2];
-	int iTmp;
-	char* token = strtok(envState, "\n");
-	while(token != NULL)
-	{
-		// Position, value, shape
-		if(sscanf(token, "PT %lf %lf %d\n", &dTmp[0], &dTmp[1], &iTmp) == 3)
-		{
-			if(dTmp[0]>=dEndPos)
-				break;
-			if(dTmp[0]>dStartPos)
-			{
-				token = strtok(NULL, "\n");
-				continue;
-			}
-		}
-
-		if(!strcmp(token, ">"))
-			break;
-
-		newState.append(token);
-		newState.append("\n");
-		token = strtok(NULL, "\n");
-	}
-
-	writeLfoPoints(take, newState, dStartPos, dEndPos, dValMin, dValMax, waveParams, dPrecision);
-
-	newState.append(token);
-	newState.append("\n");
-	token = strtok(NULL, "\n");
-	while(token != NULL)
-	{
-		newState.append(token);
-		newState.append("\n");
-		token = strtok(NULL, "\n");
-	}
-
-
-
-//
-//ShowConsoleMsg(envState);
-
-/*
-//double dCursorPos = GetCursorPositionEx(0);
-	Main_OnCommandEx(ID_GOTO_SELITEM_END, 0, 0);
-	double dEndTime = GetCursorPositionEx(0);
-	Main_OnCommandEx(ID_GOTO_SELITEM_START, 0, 0);
-	double dStartTime = GetCursorPositionEx(0);
-//SetEditCurPos2(0, dCursorPos, true, false);
-
-	if (dStartTime==dEndTime)
-		return eERRORCODE_NULLTIMESELECTION;
-
-	double dLength = dEndTime - dStartTime;
-*/
-
-// Doesn't work when item is looped
-//PCM_source* source = GetMediaItemTake_Source(take);
-//double dLength = source->GetLength();
-//if(dLength <= 0.0)
-//	return eERRORCODE_NULLTIMESELECTION;
-
-/*
-	string newState;
-	newState.append("<TRACK_ENVELOPE_UNKNOWN\n");
-	newState.append("ACT 1\n");
-	newState.append("VIS 1 1 1.000000\n");
-	newState.append("LANEHEIGHT 0 0\n");
-	newState.append("ARM 1\n");
-	newState.append("DEFSHAPE 0\n");
-	//writeLfoPoints(newState, 0.0, dLength, dValMin, dValMax, dFreq, dStrength, dOffset, dDelay, tWaveShape, dPrecision);
-writeLfoPoints(newState, dStartPos, dEndPos, dValMin, dValMax, dFreq, dStrength, dOffset, dDelay, tWaveShape, dPrecision);
-	newState.append(">\n");
-*/
-	if(!newState.size() || !GetSetEnvelopeState(envelope, (char*)newState.c_str(), (int)newState.size()))
-		return eERRORCODE_UNKNOWN;
+	vector<LfoPoint> points;
+	writeLfoPoints(take, points, dStartPos, dEndPos, dValMin, dValMax, waveParams, dTolerance);
+	insertLfoPoints(envelope, points, dStartPos, dEndPos);
 
 /* JFB commented: "recursive" undo point, enabled at top level
 	Undo_OnStateChangeEx("Take Envelope LFO", UNDO_STATE_ALL, -1);
@@ -826,7 +731,7 @@ EnvelopeProcessor::ErrorCode EnvelopeProcessor::generateTakeLfo(MediaItem_Take*
 	dStartPos -= dItemStartPos;
 	dEndPos -= dItemStartPos;
 
-	return generateTakeLfo(take, dStartPos, dEndPos, _parameters.takeEnvType, _parameters.waveParams, _parameters.precision);
+	return generateTakeLfo(take, dStartPos, dEndPos, _parameters.takeEnvType, _parameters.waveParams, LfoTolerance(_parameters.precision));
 }
 
 EnvelopeProcessor::ErrorCode EnvelopeProcessor::generateSelectedTakesLfo()
@@ -837,6 +742,7 @@ EnvelopeProcessor::ErrorCode EnvelopeProcessor::generateSelectedTakesLfo()
 		return eERRORCODE_NOITEMSELECTED;
 
 	Undo_BeginBlock2(NULL);
+	PreventUIRefresh(1);
 
 	for(list<MediaItem*>::iterator item = items.begin(); item != items.end(); item++)
 	{
@@ -850,10 +756,15 @@ EnvelopeProcessor::ErrorCode EnvelopeProcessor::generateSelectedTakesLfo()
 			ErrorCode res = generateTakeLfo(*take);
 			UpdateItemInProject(*item);
 			if(res != eERRORCODE_OK)
+			{
+				PreventUIRefresh(-1);
 				return res;
+			}
 		}
 	}
 
+	PreventUIRefresh(-1);
+
 	//Undo_OnStateChangeEx("Item Envelope LFO", UNDO_STATE_ALL, -1);
 //	UpdateTimeline();
 	Undo_EndBlock2(NULL, __LOCALIZE("Take envelope LFO","sws_undo"), UNDO_STATE_TRACKCFG);
@@ -1093,8 +1004,13 @@ EnvelopeProcessor::ErrorCode EnvelopeProcessor::processTakeEnv(MediaItem_Take* t
 	if(!envelope)
 		return eERRORCODE_NOENVELOPE;
 
-	string envStateStr = envelope::GetEnvelopeStateChunkBig(envelope);
-	char* envState = &envStateStr[0];
+	char* envState;
+	try {
+		envState = &envelope::GetEnvelopeStateChunkBuffer(envelope)[0];
+	}
+	catch (const envelope::bad_get_env_chunk_big &) {
+		return eERRORCODE_NOOBJSTATE;
+	}
 	string newState;
 	ErrorCode res = processPoints(envState, newState, dStartPos, dEndPos, dValMin, dValMax, envModType, dStrength, dOffset);
 
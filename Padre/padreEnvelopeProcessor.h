@@ -88,6 +88,13 @@ class EnvelopeProcessor
 	private:
 		static EnvelopeProcessor* _pInstance;
 
+		struct LfoPoint
+		{
+			double position;
+			double value;
+			EnvShape shape;
+		};
+
 		EnvelopeProcessor();
 		~EnvelopeProcessor();
 
@@ -135,12 +142,13 @@ ErrorCode processSelectedTakes();
 	protected:
 		static void getFreqDelay(LfoWaveParams &waveParams, double &dFreq, double &dDelay);
 		static ErrorCode getTrackEnvelopeMinMax(TrackEnvelope* envelope, double &dEnvMinVal, double &dEnvMaxVal);
-		static void writeLfoPoints(MediaItem_Take* take, string &envState, double dStartTime, double dEndTime, double dValMin, double dValMax, LfoWaveParams &waveParams, double dPrecision = 0.1, LfoWaveParams* freqModulator = NULL);
+		static void writeLfoPoints(MediaItem_Take* take, vector<LfoPoint> &points, double dStartTime, double dEndTime, double dValMin, double dValMax, LfoWaveParams &waveParams, double dTolerance = 0.02);
+		static void insertLfoPoints(TrackEnvelope* envelope, const vector<LfoPoint> &points, double dStartTime, double dEndTime);
 
 		static ErrorCode processPoints(char* envState, string &newState, double dStartPos, double dEndPos, double dValMin, double dValMax, EnvModType envModType, double dStrength = 1.0, double dOffset = 0.0);
 
-		static ErrorCode generateTrackLfo(TrackEnvelope* envelope, double dStartPos, double dEndPos, LfoWaveParams &waveParams, double dPrecision = 0.1);
-		static ErrorCode generateTakeLfo(MediaItem_Take* take, double dStartPos, double dEndPos, TakeEnvType tTakeEnvType, LfoWaveParams &waveParams, double dPrecision = 0.1);
+		static ErrorCode generateTrackLfo(TrackEnvelope* envelope, double dStartPos, double dEndPos, LfoWaveParams &waveParams, double dTolerance = 0.02);
+		static ErrorCode generateTakeLfo(MediaItem_Take* take, double dStartPos, double dEndPos, TakeEnvType tTakeEnvType, LfoWaveParams &waveParams, double dTolerance = 0.02);
 
 		ErrorCode generateTakeLfo(MediaItem_Take* take);
 ErrorCode processTakeEnv(MediaItem_Take* take);
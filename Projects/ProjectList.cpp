@@ -38,18 +38,34 @@ static SWS_LVColumn g_cols[] = { { 30, 0, "#" }, { 100, 0, "Name" }, { 185, 0, "
 // !WANT_LOCALIZE_STRINGS_END
 
 SWS_ProjectListView::SWS_ProjectListView(HWND hwndList, HWND hwndEdit)
-:SWS_ListView(hwndList, hwndEdit, 3, g_cols, "ProjListViewState", false, "sws_DLG_146")
+:SWS_ListView(hwndList, hwndEdit, 3, g_cols, "ProjListViewState", true, "sws_DLG_146")
 {
 }
 
+// Returns the project's tab index and filename as of the last GetItemList()
+int SWS_ProjectListView::GetProjectInfo(ReaProject* proj, char* cFilename, int iMax)
+{
+	std::map<ReaProject*, int>::const_iterator it = m_tabs.find(proj);
+	if (it == m_tabs.end())
+	{
+		// not enumerated yet
+		int i = 0;
+		ReaProject* p;
+		while ((p = EnumProjects(i, cFilename, iMax)) && p != proj)
+			i++;
+		if (!p)
+			*cFilename = 0;
+		return i;
+	}
+	lstrcpyn(cFilename, m_filenames.at(it->second).c_str(), iMax);
+	return it->second;
+}
+
 void SWS_ProjectListView::GetItemText(SWS_ListItem* item, int iCol, char* str, int iStrMax)
 {
-	ReaProject* proj = (ReaProject*)item;
-	int i = 0;
 	char cFilename[512];
-	while (proj != EnumProjects(i, cFilename, 512))
-		i++;
-	
+	int i = GetProjectInfo((ReaProject*)item, cFilename, sizeof(cFilename));
+
 	switch (iCol)
 	{
 	case 0: // #
@@ -79,6 +95,22 @@ void SWS_ProjectListView::GetItemText(SWS_ListItem* item, int iCol, char* str, i
 	}
 }
 
+void SWS_ProjectListView::GetItemTooltip(SWS_ListItem* item, char* str, int iStrMax)
+{
+	char cFilename[512];
+	GetProjectInfo((ReaProject*)item, cFilename, sizeof(cFilename));
+
+	lstrcpyn(str, cFilename, iStrMax);
+
+	int iTracks, iMediaFiles;
+	if (cFilename[0] && GetProjectScanInfo(cFilename, &iTracks, &iMediaFiles))
+	{
+		char cInfo[128];
+		snprintf(cInfo, sizeof(cInfo), __LOCALIZE_VERFMT("Saved: %d tracks, %d media files","sws_DLG_146"), iTracks, iMediaFiles);
+		snprintf(str + strlen(str), iStrMax - strlen(str), "\n%s", cInfo);
+	}
+}
+
 void SWS_ProjectListView::OnItemDblClk(SWS_ListItem* item, int iCol)
 {
 	SelectProjectInstance((ReaProject*)item);
@@ -87,14 +119,24 @@ void SWS_ProjectListView::OnItemDblClk(SWS_ListItem* item, int iCol)
 
 void SWS_ProjectListView::GetItemList(SWS_ListItemList* pList)
 {
+	m_tabs.clear();
+	m_filenames.clear();
+
 	ReaProject* proj;
+	char cFilename[512];
 	int i = 0;
-	while((proj = EnumProjects(i++, NULL, 0)))
+	while((proj = EnumProjects(i, cFilename, sizeof(cFilename))))
+	{
 		pList->Add((SWS_ListItem*)proj);
+		m_tabs[proj] = i++;
+		m_filenames.push_back(cFilename);
+		RequestProjectScan(cFilename); // no-op if the saved file is unchanged
+	}
 }
 
 SWS_ProjectListWnd::SWS_ProjectListWnd()
 :SWS_DockWnd(IDD_PROJLIST, __LOCALIZE("Project List","sws_DLG_157"), "SWSProjectList", SWSGetCommandID(OpenProjectList))
+,m_iScanUpdateCnt(-1)
 {
 	// Must call SWS_DockWnd::Init() to restore parameters and open the window if necessary
 	Init();
@@ -111,6 +153,24 @@ void SWS_ProjectListWnd::OnInitDlg()
 	m_resize.init_item(IDC_LIST, 0.0, 0.0, 1.0, 1.0);
 	m_pLists.Add(new SWS_ProjectListView(GetDlgItem(m_hwnd, IDC_LIST), GetDlgItem(m_hwnd, IDC_EDIT)));
 	Update();
+
+	SetTimer(m_hwnd, 1, 500, NULL);
+}
+
+void SWS_ProjectListWnd::OnDestroy()
+{
+	KillTimer(m_hwnd, 1);
+}
+
+// Refresh tooltips when background project scans complete
+void SWS_ProjectListWnd::OnTimer(WPARAM wParam)
+{
+	const int iCnt = GetProjectScanIndexUpdateCount();
+	if (iCnt != m_iScanUpdateCnt)
+	{
+		m_iScanUpdateCnt = iCnt;
+		Update();
+	}
 }
 
 void SWS_ProjectListWnd::OnCommand(WPARAM wParam, LPARAM lParam)
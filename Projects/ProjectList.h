@@ -35,8 +35,14 @@ public:
 
 protected:
 	void GetItemText(SWS_ListItem* item, int iCol, char* str, int iStrMax);
+	void GetItemTooltip(SWS_ListItem* item, char* str, int iStrMax);
 	void OnItemDblClk(SWS_ListItem* item, int iCol);
 	void GetItemList(SWS_ListItemList* pList);
+
+private:
+	int GetProjectInfo(ReaProject* proj, char* cFilename, int iMax);
+	std::map<ReaProject*, int> m_tabs; // tab indexes, cached by GetItemList()
+	std::vector<std::string> m_filenames;
 };
 
 class SWS_ProjectListWnd : public SWS_DockWnd
@@ -47,9 +53,13 @@ public:
 	
 protected:
 	void OnInitDlg();
+	void OnDestroy();
+	void OnTimer(WPARAM wParam = 0);
 	void OnCommand(WPARAM wParam, LPARAM lParam);
 	HMENU OnContextMenu(int x, int y, bool* wantDefaultItems);
 	int OnKey(MSG* msg, int iKeyState);
+
+	int m_iScanUpdateCnt;
 };
 
 void OpenProjectList(COMMAND_T*);
@@ -28,7 +28,9 @@
 
 #include "stdafx.h"
 #include "../reaper/localize.h"
+#include "../SnM/SnM.h"
 #include "../SnM/SnM_Dlg.h"
+#include "../SnM/SnM_Util.h"
 #include "ProjectMgr.h"
 #include "ProjectList.h"
 
@@ -36,6 +38,350 @@
 static SWSProjConfig<WDL_PtrList_DOD<WDL_String> > g_relatedProjects;
 
 #define DELWINDOW_POS_KEY "DelRelatedProjectWindowPosition"
+#define PREFETCH_BLOCK_SIZE			65536
+#define PREFETCH_MEDIA_HEADER_SIZE	65536
+#define PROJ_INDEX_FILE				"%s/SWS-ProjectIndex.txt"
+#define PROJ_INDEX_VERSION			"SWS project index v1"
+
+// ****************************************************************************
+// **** Project scan index ****************************************************
+// ****************************************************************************
+// Saved projects (track count, referenced media) are scanned by a background
+// thread, entries are validated against the file size/date. The index is
+// saved in the resource path so that it survives restarts, loaded entries are
+// re-validated the first time they are looked up. The same thread prefetches
+// projects (and their media headers) into the OS file cache ahead of REAPER
+// loading them.
+struct ProjectIndexEntry
+{
+	time_t mtime;
+	WDL_INT64 size;
+	int iTracks;
+	std::vector<std::string> media;
+	bool bChecked; // validated against the file since startup, not saved
+};
+
+struct ProjectScanRequest
+{
+	std::string fn;
+	bool bPrefetch;
+};
+
+static SWS_Mutex g_projIndexMutex;
+static std::map<std::string, ProjectIndexEntry> g_projIndex;
+static std::list<ProjectScanRequest> g_projScanQueue;
+static HANDLE g_projScanThread = NULL;
+static bool g_bProjScanRunning = false;
+static bool g_bProjScanQuit = false;
+static bool g_bProjIndexDirty = false;
+static int g_iProjIndexUpdateCnt = 0;
+
+static bool IsProjectScanQuitting()
+{
+	SWS_SectionLock lock(&g_projIndexMutex);
+	return g_bProjScanQuit;
+}
+
+static bool IsAbsolutePath(const char* path)
+{
+#ifdef _WIN32
+	return (path[0] && path[1] == ':') || path[0] == '\\' || path[0] == '/';
+#else
+	return path[0] == '/';
+#endif
+}
+
+// Only looks at line starts: long lines (MIDI, base64 state...) are skipped
+static void ScanProjectFile(const char* fn, ProjectIndexEntry* pEntry)
+{
+	pEntry->iTracks = 0;
+	pEntry->media.clear();
+
+	FILE* f = fopenUTF8(fn, "rb");
+	if (!f)
+		return;
+
+	std::string dir(fn);
+	dir.erase(dir.find_last_of("\\/") + 1);
+
+	std::set<std::string> media;
+	char buf[4096];
+	bool bLineStart = true;
+	while (fgets(buf, sizeof(buf), f))
+	{
+		size_t len = strlen(buf);
+		const bool bWasLineStart = bLineStart;
+		bLineStart = len && buf[len-1] == '\n';
+		if (!bWasLineStart)
+			continue;
+
+		while (len && (buf[len-1] == '\n' || buf[len-1] == '\r'))
+			buf[--len] = 0;
+
+		const char* p = buf;
+		while (*p == ' ' || *p == '\t')
+			p++;
+
+		if (!strncmp(p, "<TRACK", 6) && (!p[6] || p[6] == ' '))
+			pEntry->iTracks++;
+		else if (!strncmp(p, "FILE ", 5))
+		{
+			LineParser lp(false);
+			if (!lp.parse(p) && lp.getnumtokens() > 1 && *lp.gettoken_str(1))
+			{
+				const char* mediafn = lp.gettoken_str(1);
+				media.insert(IsAbsolutePath(mediafn) ? std::string(mediafn) : dir + mediafn);
+			}
+		}
+	}
+	fclose(f);
+
+	pEntry->media.assign(media.begin(), media.end());
+}
+
+static void PrefetchFile(const char* fn, int maxBytes)
+{
+	if (FILE* f = fopenUTF8(fn, "rb"))
+	{
+		char* buf = new char[PREFETCH_BLOCK_SIZE];
+		int total = 0;
+		size_t read;
+		while ((maxBytes < 0 || total < maxBytes) && (read = fread(buf, 1, PREFETCH_BLOCK_SIZE, f)) > 0)
+			total += (int)read;
+		delete [] buf;
+		fclose(f);
+	}
+}
+
+static unsigned int WINAPI ProjectScanThread(void*)
+{
+	for (;;)
+	{
+		ProjectScanRequest req;
+		{
+			SWS_SectionLock lock(&g_projIndexMutex);
+			if (g_bProjScanQuit || g_projScanQueue.empty())
+			{
+				g_bProjScanRunning = false;
+				return 0;
+			}
+			req = g_projScanQueue.front();
+			g_projScanQueue.pop_front();
+		}
+
+		time_t mtime;
+		WDL_INT64 size;
+		if (!GetFileStamp(req.fn.c_str(), &mtime, &size))
+		{
+			// project deleted/moved: drop its entry
+			SWS_SectionLock lock(&g_projIndexMutex);
+			if (g_projIndex.erase(req.fn))
+			{
+				g_bProjIndexDirty = true;
+				g_iProjIndexUpdateCnt++;
+			}
+			continue;
+		}
+
+		std::vector<std::string> media;
+		bool bUpToDate = false;
+		{
+			SWS_SectionLock lock(&g_projIndexMutex);
+			std::map<std::string, ProjectIndexEntry>::iterator it = g_projIndex.find(req.fn);
+			if (it != g_projIndex.end() && it->second.mtime == mtime && it->second.size == size)
+			{
+				bUpToDate = true;
+				it->second.bChecked = true;
+				if (req.bPrefetch)
+					media = it->second.media;
+			}
+		}
+
+		if (!bUpToDate)
+		{
+			// the scan reads the whole file, which also prefetches it
+			ProjectIndexEntry entry;
+			entry.mtime = mtime;
+			entry.size = size;
+			entry.bChecked = true;
+			ScanProjectFile(req.fn.c_str(), &entry);
+			media = entry.media;
+
+			SWS_SectionLock lock(&g_projIndexMutex);
+			g_projIndex[req.fn] = entry;
+			g_bProjIndexDirty = true;
+			g_iProjIndexUpdateCnt++;
+		}
+		else if (req.bPrefetch)
+			PrefetchFile(req.fn.c_str(), -1);
+
+		if (req.bPrefetch)
+			for (const std::string &mediafn : media)
+			{
+				if (IsProjectScanQuitting())
+					break;
+				PrefetchFile(mediafn.c_str(), PREFETCH_MEDIA_HEADER_SIZE);
+			}
+	}
+}
+
+// Queues a (re)scan of a saved project, up-to-date entries are not rescanned
+void RequestProjectScan(const char* fn, bool bPrefetch)
+{
+	if (!fn || !*fn)
+		return;
+
+	SWS_SectionLock lock(&g_projIndexMutex);
+	if (g_bProjScanQuit)
+		return;
+
+	bool bQueued = false;
+	for (ProjectScanRequest &req : g_projScanQueue)
+	{
+		if (req.fn == fn)
+		{
+			req.bPrefetch |= bPrefetch;
+			bQueued = true;
+			break;
+		}
+	}
+	if (!bQueued)
+	{
+		ProjectScanRequest req;
+		req.fn = fn;
+		req.bPrefetch = bPrefetch;
+		g_projScanQueue.push_back(req);
+	}
+
+	if (!g_bProjScanRunning)
+	{
+		if (g_projScanThread) // previous run is over
+		{
+			WaitForSingleObject(g_projScanThread, INFINITE);
+			CloseHandle(g_projScanThread);
+		}
+		g_projScanThread = (HANDLE)_beginthreadex(NULL, 0, ProjectScanThread, NULL, 0, NULL);
+		g_bProjScanRunning = g_projScanThread != NULL;
+	}
+}
+
+// Returns false if the project has not been scanned yet (a scan is queued then).
+// Entries loaded from disk are returned as is, but a validation is queued.
+bool GetProjectScanInfo(const char* fn, int* iTracks, int* iMediaFiles)
+{
+	if (!fn || !*fn)
+		return false;
+
+	bool bFound = false;
+	{
+		SWS_SectionLock lock(&g_projIndexMutex);
+		std::map<std::string, ProjectIndexEntry>::iterator it = g_projIndex.find(fn);
+		if (it != g_projIndex.end())
+		{
+			if (iTracks) *iTracks = it->second.iTracks;
+			if (iMediaFiles) *iMediaFiles = (int)it->second.media.size();
+			if (it->second.bChecked)
+				return true;
+			it->second.bChecked = true; // queue the validation once
+			bFound = true;
+		}
+	}
+	RequestProjectScan(fn);
+	return bFound;
+}
+
+// Incremented each time an entry is (re)scanned, lets UIs refresh
+int GetProjectScanIndexUpdateCount()
+{
+	SWS_SectionLock lock(&g_projIndexMutex);
+	return g_iProjIndexUpdateCnt;
+}
+
+// Format: a version line, then per project
+// P<tab>size<tab>mtime<tab>tracks<tab>path
+// M<tab>media path (one line per referenced media file)
+static void LoadProjectIndex()
+{
+	WDL_FastString fn;
+	fn.SetFormatted(SNM_MAX_PATH, PROJ_INDEX_FILE, GetResourcePath());
+	FILE* f = fopenUTF8(fn.Get(), "r");
+	if (!f)
+		return;
+
+	SWS_SectionLock lock(&g_projIndexMutex);
+	char buf[SNM_MAX_PATH+128];
+	if (fgets(buf, sizeof(buf), f) && !strncmp(buf, PROJ_INDEX_VERSION, strlen(PROJ_INDEX_VERSION)))
+	{
+		ProjectIndexEntry* pEntry = NULL;
+		while (fgets(buf, sizeof(buf), f))
+		{
+			size_t len = strlen(buf);
+			while (len && (buf[len-1] == '\n' || buf[len-1] == '\r'))
+				buf[--len] = 0;
+
+			if (buf[0] == 'P' && buf[1] == '\t')
+			{
+				pEntry = NULL;
+				char* p = buf + 2;
+				ProjectIndexEntry entry;
+				entry.size = (WDL_INT64)strtoll(p, &p, 10);
+				entry.mtime = (time_t)strtoll(p, &p, 10);
+				entry.iTracks = (int)strtol(p, &p, 10);
+				entry.bChecked = false;
+				if (*p == '\t' && p[1])
+				{
+					pEntry = &g_projIndex[p + 1];
+					*pEntry = entry;
+				}
+			}
+			else if (buf[0] == 'M' && buf[1] == '\t' && buf[2] && pEntry)
+				pEntry->media.push_back(buf + 2);
+		}
+	}
+	fclose(f);
+	g_bProjIndexDirty = false;
+}
+
+// Called once the scan thread is over
+static void SaveProjectIndex()
+{
+	if (!g_bProjIndexDirty)
+		return;
+
+	WDL_FastString fn;
+	fn.SetFormatted(SNM_MAX_PATH, PROJ_INDEX_FILE, GetResourcePath());
+	FILE* f = fopenUTF8(fn.Get(), "w");
+	if (!f)
+		return;
+
+	fprintf(f, "%s\n", PROJ_INDEX_VERSION);
+	for (std::map<std::string, ProjectIndexEntry>::const_iterator it = g_projIndex.begin(); it != g_projIndex.end(); ++it)
+	{
+		fprintf(f, "P\t%lld\t%lld\t%d\t%s\n", (long long)it->second.size, (long long)it->second.mtime, it->second.iTracks, it->first.c_str());
+		for (const std::string &mediafn : it->second.media)
+			fprintf(f, "M\t%s\n", mediafn.c_str());
+	}
+	fclose(f);
+	g_bProjIndexDirty = false;
+}
+
+static void ProjectScanExit()
+{
+	HANDLE thread;
+	{
+		SWS_SectionLock lock(&g_projIndexMutex);
+		g_bProjScanQuit = true;
+		g_projScanQueue.clear();
+		thread = g_projScanThread;
+		g_projScanThread = NULL;
+	}
+	if (thread)
+	{
+		WaitForSingleObject(thread, INFINITE);
+		CloseHandle(thread);
+	}
+	SaveProjectIndex();
+}
 
 // ****************************************************************************
 // **** Project list  *********************************************************
@@ -113,19 +459,27 @@ void OpenProjectsFromList(COMMAND_T*)
 		}
 	}
 
+	std::vector<std::string> projectFiles;
 	std::string line;
 	while (std::getline(file, line))
 	{
-		if(line.empty())
-			continue;
+		if (!line.empty())
+			projectFiles.push_back(line);
+	}
+	file.close();
 
+	// Prefetch projects and media headers in the background, in load order,
+	// while REAPER loads the first tabs
+	for (const std::string &projectfn : projectFiles)
+		RequestProjectScan(projectfn.c_str(), true);
+
+	for (const std::string &projectfn : projectFiles)
+	{
 		if (projectCount > 0)
 			Main_OnCommand(41929, 0); // New project tab (ignore default template)
 
-		Main_openProject(line.c_str());
+		Main_openProject(projectfn.c_str());
 	}
-
-	file.close();
 }
 
 // ****************************************************************************
@@ -177,6 +531,8 @@ void OpenRelatedProject(COMMAND_T* pCmd)
 	}
 
 	// Nope, open in new tab
+	RequestProjectScan(pStr->Get(), true);
+
 	// Save "prompt on new project" variable
 	ConfigVarOverride<int> newprojdo("newprojdo", 0);
 	pProj = EnumProjects(-1, NULL, 0);
@@ -418,11 +774,14 @@ int ProjectMgrInit()
 	if (!plugin_register("hookcustommenu", (void*)menuhook))
 		return 0;
 
+	LoadProjectIndex();
 	return 1;
 }
 
 void ProjectMgrExit()
 {
+	ProjectScanExit();
+
 	plugin_register("-projectconfig",&g_projectconfig);
 	plugin_register("-hookcustommenu", (void*)menuhook);
 }
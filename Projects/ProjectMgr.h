@@ -31,6 +31,9 @@
 extern COMMAND_T g_projMgrCmdTable[];
 
 void UpdateOpenProjectTabActions();
+void RequestProjectScan(const char* fn, bool bPrefetch = false);
+bool GetProjectScanInfo(const char* fn, int* iTracks, int* iMediaFiles);
+int GetProjectScanIndexUpdateCount();
 int ProjectMgrInit();
 void ProjectMgrExit();
 
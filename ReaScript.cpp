@@ -158,6 +158,8 @@ APIdef g_apidefs[] =
 	{ APIFUNC(SNM_AddTCPFXParm), "bool", "MediaTrack*,int,int", "tr,fxId,prmId", "[S&M] Add an FX parameter knob in the TCP. Returns false if nothing updated (invalid parameters, knob already present, etc..)", },
 	{ APIFUNC(SNM_TagMediaFile), "bool", "const char*,const char*,const char*", "fn,tag,tagval", "[S&M] Tags a media file thanks to <a href=\"https://taglib.github.io\">TagLib</a>. Supported tags: \"artist\", \"album\", \"genre\", \"comment\", \"title\", or \"year\". Use an empty tagval to clear a tag. When a file is opened in REAPER, turn it offline before using this function. Returns false if nothing updated. See SNM_ReadMediaFileTag.", },
 	{ APIFUNC(SNM_ReadMediaFileTag), "bool", "const char*,const char*,char*,int", "fn,tag,tagval,tagval_sz", "[S&M] Reads a media file tag. Supported tags: \"artist\", \"album\", \"genre\", \"comment\", \"title\", or \"year\". Returns false if tag was not found. See SNM_TagMediaFile.", },
+	{ APIFUNC(SNM_ReadMediaFilesTagsStr), "int", "const char*,const char*,char*,int", "fns,tags,tagvalsNeedBig,tagvals_sz", "[S&M] Reads media file tags of many files at once, files are processed in parallel and tags are cached until files change. fns: one file per line. tags: comma separated list of tags, see SNM_ReadMediaFileTag. tagvals: one line per file, values in tags order, tab separated (tabs/line breaks in values are replaced with spaces). Returns the number of files with tags. See SNM_TagMediaFilesStr.", },
+	{ APIFUNC(SNM_TagMediaFilesStr), "int", "const char*,const char*,const char*", "fns,tags,tagvals", "[S&M] Tags many media files at once, files are processed in parallel. fns/tags/tagvals: same formats as SNM_ReadMediaFilesTagsStr. Use an empty value to clear a tag. When a file is opened in REAPER, turn it offline before using this function. Returns the number of updated files.", },
 
 	{ APIFUNC(FNG_AllocMidiTake), "RprMidiTake*", "MediaItem_Take*", "take", "[FNG] Allocate a RprMidiTake from a take pointer. Returns a NULL pointer if the take is not an in-project MIDI take", },
 	{ APIFUNC(FNG_FreeMidiTake), "void", "RprMidiTake*", "midiTake", "[FNG] Commit changes to MIDI take and free allocated memory", },
@@ -284,6 +286,7 @@ APIdef g_apidefs[] =
 	{ APIFUNC(NF_GetMediaItemPeakRMS_NonWindowed), "double", "MediaItem*", "item", "Returns the greatest overall (non-windowed) RMS peak level of all active channels of an audio item active take, post item gain, post take volume envelope, post-fade, pre fader, pre item FX. \n Returns -150.0 if MIDI take or empty item.", },
 	{ APIFUNC(NF_GetMediaItemAverageRMS), "double", "MediaItem*", "item", "Returns the average overall (non-windowed) RMS level of active channels of an audio item active take, post item gain, post take volume envelope, post-fade, pre fader, pre item FX. \n Returns -150.0 if MIDI take or empty item.", },
 	{ APIFUNC(NF_AnalyzeMediaItemPeakAndRMS), "bool", "MediaItem*,double,void*,void*,void*,void*", "item,windowSize,reaper.array_peaks,reaper.array_peakpositions,reaper.array_RMSs,reaper.array_RMSpositions", "This function combines all other NF_Peak/RMS functions in a single one and additionally returns peak RMS positions. Lua example code <a href=\"https://forum.cockos.com/showpost.php?p=2050961&postcount=6\">here</a>. Note: It's recommended to use this function with ReaScript/Lua as it provides reaper.array objects. If using this function with other scripting languages, you must provide arrays in the <a href=\"https://forum.cockos.com/showpost.php?p=2039829&postcount=2\">reaper.array</a> format.", },
+	{ APIFUNC(NF_AnalyzeMediaItem), "bool", "MediaItem*,double,bool,double*,double*,double*,double*,double*,double*,double*,double*,double*,double*", "item,windowSize,analyzeLoudness,peakOut,peakPosOut,averageRMSOut,peakRMSOut,peakRMSWindowedOut,peakRMSWindowedPosOut,lufsIntegratedOut,rangeOut,shortTermMaxOut,momentaryMaxOut", "Returns peak, average RMS, peak RMS (non-windowed and windowed) and optionally loudness (integrated, range, max. short-term, max. momentary) of the item, reading the item's audio only once. Values are in dB (LUFS/LU for loudness). Positions are in seconds relative to item start, -666 if not available. windowSize <= 0 uses the window set in the SWS RMS options. Note: Unlike NF_AnalyzeTakeLoudness, loudness is measured without take FX/volume/pan.", },
 
 	// #880
 	{ APIFUNC(NF_AnalyzeTakeLoudness_IntegratedOnly), "bool", "MediaItem_Take*,double*", "take,lufsIntegratedOut", "Does LUFS integrated analysis only. Faster than full loudness analysis (<a href=\"#NF_AnalyzeTakeLoudness\">NF_AnalyzeTakeLoudness</a>) . Use this if only LUFS integrated is required. Take vol. env. is taken into account. See: <a href=\"http://wiki.cockos.com/wiki/index.php/Measure_and_normalize_loudness_with_SWS\">Signal flow</a>", },
@@ -518,6 +518,7 @@ static COMMAND_T s_cmdTable[] =
 	{ { DEFACCEL, "SWS/S&M: Dump action list (custom actions only)" }, "S&M_DUMP_CUST_ACTION_LIST", DumpActionList, NULL, 16},
 	{ { DEFACCEL, "SWS/S&M: Dump action list (all but custom actions)" }, "S&M_DUMP_CUST_ACTION_LIST", DumpActionList, NULL, 4|8},
 	{ { DEFACCEL, "SWS/S&M: Dump action list (all actions)" }, "S&M_DUMP_CUST_ACTION_LIST", DumpActionList, NULL, 4|8|16},
+	{ { DEFACCEL, "SWS/S&M: Dump time slice statistics (debug)" }, "S&M_DUMP_TIMESLICE_STATS", DumpTimeSliceStats, NULL, },
 
 	{ { DEFACCEL, "SWS/S&M: Resources - Clear FX chain slot, prompt for slot" }, "S&M_CLRFXCHAINSLOT", ResourcesClearSlotPrompt, NULL, SNM_SLOT_FXC},
 	{ { DEFACCEL, "SWS/S&M: Resources - Clear track template slot, prompt for slot" }, "S&M_CLR_TRTEMPLATE_SLOT", ResourcesClearSlotPrompt, NULL, SNM_SLOT_TR},
@@ -1229,6 +1230,7 @@ void SNM_Exit()
 	RegionPlaylistExit();
 	SNM_ProjectExit();
 	CyclactionExit();
+	ChunkCacheExit();
 	SNM_UIExit();
 	IniFileExit();
 #ifdef _SNM_MISC
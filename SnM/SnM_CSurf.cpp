@@ -44,7 +44,7 @@
 // SWSTimeSlice:IReaperControlSurface callbacks
 ///////////////////////////////////////////////////////////////////////////////
 
-// called from the main thread via IReaperControlSurface::Run()
+// called from the main thread via IReaperControlSurface::Run(), on every time slice
 // processing order is important here
 void SNM_CSurfRun()
 {
@@ -57,6 +57,20 @@ void SNM_CSurfRun()
 	PlaylistRun();
 	ScheduledJob::Run();
 	StopTrackPreviewsRun();
+
+	sRecurseCheck = false;
+}
+
+// called from the main thread via IReaperControlSurface::Run(), after SNM_CSurfRun()
+// low priority: can be deferred to a later time slice when the slice is busy
+void SNM_CSurfIdleRun()
+{
+	static bool sRecurseCheck = false;
+	if (sRecurseCheck)
+		return;
+
+	sRecurseCheck = true;
+
 	UpdateMarkerRegionRun();
 	AutoRefreshToolbarRun();
 
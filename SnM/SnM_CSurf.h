@@ -33,6 +33,7 @@
 
 // SWSTimeSlice:IReaperControlSurface callbacks
 void SNM_CSurfRun();
+void SNM_CSurfIdleRun();
 void SNM_CSurfSetTrackTitle();
 void SNM_CSurfSetTrackListChange();
 void SNM_CSurfSetPlayState(bool _play, bool _pause, bool _rec);
@@ -2277,7 +2277,7 @@ void ApplyPreloadLiveConfig(bool _apply, int _cfgId, int _val, LiveConfigItem* _
 				GetFullResourcePath("TrackTemplates", cfg->m_trTemplate.Get(), fn, sizeof(fn));
 
 				static WDL_FastString tmplt; 
-				if (LoadChunk(fn, &tmplt) && tmplt.GetLength())
+				if (LoadChunkCached(fn, &tmplt) && tmplt.GetLength())
 				{
 					SNM_SendPatcher p(cfg->m_track); // auto-commit on destroy
 					
@@ -2304,7 +2304,7 @@ void ApplyPreloadLiveConfig(bool _apply, int _cfgId, int _val, LiveConfigItem* _
 			{
 				char fn[SNM_MAX_PATH]="";
 				GetFullResourcePath("FXChains", cfg->m_fxChain.Get(), fn, sizeof(fn));
-				if (LoadChunk(fn, &chunk) && chunk.GetLength())
+				if (LoadChunkCached(fn, &chunk) && chunk.GetLength())
 				{
 					SNM_FXChainTrackPatcher p(cfg->m_track); // auto-commit on destroy
 					if (p.SetFXChain(&chunk))
@@ -36,6 +36,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 DWORD g_mkrRgnNotifyTime = 0; // really approx (updated on timer)
+int g_mkrRgnUpdateCnt = 0; // incremented when UpdateMarkerRegionCache() detects changes
 WDL_PtrList<MarkerRegion> g_mkrRgnCache;
 WDL_PtrList<SNM_MarkerRegionListener> g_mkrRgnListeners;
 
@@ -82,11 +83,20 @@ int UpdateMarkerRegionCache()
 		if (const ConfigVar<int> timemode = "projtimemode")
 			if (*timemode != sPrevTimemode) {
 				sPrevTimemode = *timemode;
+				g_mkrRgnUpdateCnt++;
 				return SNM_MARKER_MASK|SNM_REGION_MASK;
 			}
+	if (updateFlags)
+		g_mkrRgnUpdateCnt++;
 	return updateFlags;
 }
 
+// note: only reliable while listeners are registered (see UpdateMarkerRegionRun()), caches
+// should also be keyed on the project state change count
+int GetMarkerRegionUpdateCount() {
+	return g_mkrRgnUpdateCnt;
+}
+
 // notify marker/region listeners?
 // polled via SNM_CSurfRun()
 void UpdateMarkerRegionRun()
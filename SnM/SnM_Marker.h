@@ -45,6 +45,7 @@ public:
 void RegisterToMarkerRegionUpdates(SNM_MarkerRegionListener* _sub);
 void UnregisterToMarkerRegionUpdates(SNM_MarkerRegionListener* _sub) ;
 void UpdateMarkerRegionRun();
+int GetMarkerRegionUpdateCount();
 
 int FindMarkerRegion(ReaProject* _proj, double _pos, int _flags, int* _idOut = NULL);
 int MakeMarkerRegionId(int _num, bool _isRgn);
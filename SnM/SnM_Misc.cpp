@@ -231,28 +231,13 @@ bool SNM_ReadMediaFileTag(const char *fn, const char* tag, char* tagval, int tag
   if (!fn || !*fn || !tagval || tagval_sz<=0) return false;
   *tagval=0;
 
-  TagLib::FileRef f(win32::widen(fn).c_str(), false);
-
-  if (!f.isNull() && !f.tag()->isEmpty())
+  int tagId = SNM_GetMediaFileTagId(tag);
+  if (tagId>=0)
   {
-    TagLib::String s;
-    if (!_stricmp(tag, "artist")) s=f.tag()->artist();
-    else if (!_stricmp(tag, "album")) s=f.tag()->album();
-    else if (!_stricmp(tag, "genre")) s=f.tag()->genre();
-    else if (!_stricmp(tag, "comment")) s=f.tag()->comment();
-    else if (!_stricmp(tag, "title")) s=f.tag()->title();
-    if (s.length())
-    {
-      const char *p=s.toCString(true);
-      if (strcmp(p,"0")) lstrcpyn(tagval, p, tagval_sz); // must be a taglib bug...
-    }
-    else
-    {
-      if (!_stricmp(tag, "year") && f.tag()->year()) snprintf(tagval, tagval_sz, "%u", f.tag()->year());
-      else if (!_stricmp(tag, "track") && f.tag()->track()) snprintf(tagval, tagval_sz, "%u", f.tag()->track());
-    }
+    SNM_MediaFileTags tags(fn);
+    if (SNM_ReadMediaFileTags(&tags))
+      lstrcpyn(tagval, tags.m_tags[tagId].Get(), tagval_sz);
   }
-
   return !!*tagval;
 }
 
@@ -260,31 +245,363 @@ bool SNM_TagMediaFile(const char *fn, const char* tag, const char* tagval)
 {
   if (!fn || !*fn || !tagval || !tag) return false;
 
-  TagLib::FileRef f(win32::widen(fn).c_str(), false);
+  int tagId = SNM_GetMediaFileTagId(tag);
+  if (tagId<0) return false;
 
-  bool didsmthg=false;
-  if (!f.isNull())
-  {
-    TagLib::String s(tagval, TagLib::String::UTF8);
-    if (!_stricmp(tag, "artist")) { f.tag()->setArtist(s); didsmthg=true; }
-    else if (!_stricmp(tag, "album")) { f.tag()->setAlbum(s); didsmthg=true; }
-    else if (!_stricmp(tag, "genre")) { f.tag()->setGenre(s); didsmthg=true; }
-    else if (!_stricmp(tag, "comment") || !_stricmp(tag, "desc")) { f.tag()->setComment(s); didsmthg=true; }
-    else if (!_stricmp(tag, "title")) { f.tag()->setTitle(s); didsmthg=true; }
-    else if (!_stricmp(tag, "year"))
-    {
-      int val=atoi(tagval);
-      if (val>0 || !*tagval) { f.tag()->setYear(val); didsmthg=true; }
-    }
-    else if (!_stricmp(tag, "track"))
-    {
-      int val=atoi(tagval);
-      if (val>0 || !*tagval) { f.tag()->setTrack(val); didsmthg=true; }
-    }
-    if (didsmthg) f.save();
-  }
+  SNM_MediaFileTags tags(fn);
+  tags.m_tags[tagId].Set(tagval);
+  tags.m_setMask = 1<<tagId;
+  return SNM_WriteMediaFileTags(&tags);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Media file tags: all supported tags of a file are read at once and cached
+// (validated against file size/date), batches are written by worker threads
+///////////////////////////////////////////////////////////////////////////////
+
+#define SNM_TAG_CACHE_MAX_FILES		1024
+#define SNM_TAG_THREADS				8
+#define SNM_TAG_MIN_PER_THREAD		8
+
+struct SNM_CachedTags
+{
+	SNM_MediaFileTags tags;
+	time_t mtime;
+	WDL_INT64 size;
+	unsigned int lastUse;
+};
+
+static void DisposeCachedTags(SNM_CachedTags* _c) { delete _c; }
+
+static SWS_Mutex g_tagCacheMutex;
+static WDL_StringKeyedArray<SNM_CachedTags*> g_tagCache(true, DisposeCachedTags);
+static unsigned int g_tagCacheClock = 0;
+
+static void CopyMediaFileTags(const SNM_MediaFileTags* _src, SNM_MediaFileTags* _dest)
+{
+	for (int i=0; i<SNM_NUM_TAGS; i++)
+		_dest->m_tags[i].Set(_src->m_tags[i].Get());
+	_dest->m_ok = _src->m_ok;
+}
+
+static bool GetCachedTags(SNM_MediaFileTags* _tags, time_t _mtime, WDL_INT64 _size)
+{
+	SWS_SectionLock lock(&g_tagCacheMutex);
+	if (SNM_CachedTags* c = g_tagCache.Get(_tags->m_fn.Get(), NULL))
+	{
+		if (c->mtime==_mtime && c->size==_size)
+		{
+			c->lastUse = ++g_tagCacheClock;
+			CopyMediaFileTags(&c->tags, _tags);
+			return true;
+		}
+		g_tagCache.Delete(_tags->m_fn.Get()); // out of date
+	}
+	return false;
+}
 
-  return didsmthg;
+static void CacheTags(const SNM_MediaFileTags* _tags, time_t _mtime, WDL_INT64 _size)
+{
+	SWS_SectionLock lock(&g_tagCacheMutex);
+	if (g_tagCache.GetSize() >= SNM_TAG_CACHE_MAX_FILES)
+	{
+		// evict the least recently used file
+		const char* key = NULL; WDL_FastString lruKey;
+		unsigned int lruUse = 0;
+		for (int i=0; i<g_tagCache.GetSize(); i++)
+		{
+			SNM_CachedTags* c = g_tagCache.Enumerate(i, &key);
+			if (c && key && (!lruKey.GetLength() || c->lastUse < lruUse)) {
+				lruKey.Set(key);
+				lruUse = c->lastUse;
+			}
+		}
+		if (lruKey.GetLength())
+			g_tagCache.Delete(lruKey.Get());
+	}
+
+	SNM_CachedTags* c = new SNM_CachedTags;
+	c->tags.m_fn.Set(_tags->m_fn.Get());
+	CopyMediaFileTags(_tags, &c->tags);
+	c->mtime = _mtime;
+	c->size = _size;
+	c->lastUse = ++g_tagCacheClock;
+	g_tagCache.Insert(_tags->m_fn.Get(), c); // replaces (and disposes) any previous entry
+}
+
+static void InvalidateCachedTags(const char* _fn)
+{
+	SWS_SectionLock lock(&g_tagCacheMutex);
+	g_tagCache.Delete(_fn);
+}
+
+// returns -1 if unknown, "desc" is an alias for "comment"
+int SNM_GetMediaFileTagId(const char* _tag)
+{
+	static const char* sTagNames[SNM_NUM_TAGS] = { "artist", "album", "genre", "comment", "title", "year", "track" };
+	if (_tag)
+	{
+		for (int i=0; i<SNM_NUM_TAGS; i++)
+			if (!_stricmp(_tag, sTagNames[i]))
+				return i;
+		if (!_stricmp(_tag, "desc"))
+			return SNM_TAG_COMMENT;
+	}
+	return -1;
+}
+
+// reads all tags of _tags->m_fn with a single file open, cached
+bool SNM_ReadMediaFileTags(SNM_MediaFileTags* _tags)
+{
+	time_t mtime; WDL_INT64 size;
+	bool stamped = GetFileStamp(_tags->m_fn.Get(), &mtime, &size);
+	if (stamped && GetCachedTags(_tags, mtime, size))
+		return _tags->m_ok;
+
+	for (int i=0; i<SNM_NUM_TAGS; i++)
+		_tags->m_tags[i].Set("");
+	_tags->m_ok = false;
+
+	if (stamped)
+	{
+		TagLib::FileRef f(win32::widen(_tags->m_fn.Get()).c_str(), false);
+		if (!f.isNull() && !f.tag()->isEmpty())
+		{
+			TagLib::Tag* t = f.tag();
+			TagLib::String s[SNM_TAG_TITLE+1];
+			s[SNM_TAG_ARTIST] = t->artist();
+			s[SNM_TAG_ALBUM] = t->album();
+			s[SNM_TAG_GENRE] = t->genre();
+			s[SNM_TAG_COMMENT] = t->comment();
+			s[SNM_TAG_TITLE] = t->title();
+			for (int i=0; i<=SNM_TAG_TITLE; i++)
+			{
+				if (s[i].length())
+				{
+					const char *p=s[i].toCString(true);
+					if (strcmp(p,"0")) _tags->m_tags[i].Set(p); // must be a taglib bug...
+				}
+			}
+			if (t->year()) _tags->m_tags[SNM_TAG_YEAR].SetFormatted(32, "%u", t->year());
+			if (t->track()) _tags->m_tags[SNM_TAG_TRACK].SetFormatted(32, "%u", t->track());
+			_tags->m_ok = true;
+		}
+		CacheTags(_tags, mtime, size);
+	}
+	return _tags->m_ok;
+}
+
+// writes the tags flagged in _tags->m_setMask with a single file open/save
+// note: empty values clear tags, year/track must be > 0 otherwise
+bool SNM_WriteMediaFileTags(SNM_MediaFileTags* _tags)
+{
+	_tags->m_ok = false;
+	if (!_tags->m_setMask)
+		return false;
+
+	TagLib::FileRef f(win32::widen(_tags->m_fn.Get()).c_str(), false);
+
+	bool didsmthg=false;
+	if (!f.isNull())
+	{
+		TagLib::Tag* t = f.tag();
+		for (int i=0; i<SNM_NUM_TAGS; i++)
+		{
+			if (!(_tags->m_setMask & (1<<i)))
+				continue;
+
+			const char* val = _tags->m_tags[i].Get();
+			TagLib::String s(val, TagLib::String::UTF8);
+			switch (i)
+			{
+				case SNM_TAG_ARTIST: t->setArtist(s); didsmthg=true; break;
+				case SNM_TAG_ALBUM: t->setAlbum(s); didsmthg=true; break;
+				case SNM_TAG_GENRE: t->setGenre(s); didsmthg=true; break;
+				case SNM_TAG_COMMENT: t->setComment(s); didsmthg=true; break;
+				case SNM_TAG_TITLE: t->setTitle(s); didsmthg=true; break;
+				case SNM_TAG_YEAR:
+				case SNM_TAG_TRACK:
+				{
+					int num=atoi(val);
+					if (num>0 || !*val)
+					{
+						if (i==SNM_TAG_YEAR) t->setYear(num);
+						else t->setTrack(num);
+						didsmthg=true;
+					}
+					break;
+				}
+			}
+		}
+		if (didsmthg) f.save();
+	}
+
+	if (didsmthg)
+		InvalidateCachedTags(_tags->m_fn.Get());
+	return (_tags->m_ok = didsmthg);
+}
+
+struct SNM_TagsJob
+{
+	WDL_PtrList<SNM_MediaFileTags>* tags;
+	int first, step;
+	bool write;
+};
+
+static unsigned int WINAPI MediaFileTagsThread(void* _job)
+{
+	SNM_TagsJob* job = (SNM_TagsJob*)_job;
+	for (int i=job->first; i<job->tags->GetSize(); i+=job->step)
+		if (SNM_MediaFileTags* tags = job->tags->Get(i))
+		{
+			if (job->write) SNM_WriteMediaFileTags(tags);
+			else SNM_ReadMediaFileTags(tags);
+		}
+	return 0;
+}
+
+// file I/O bound: spread files over a few worker threads, each file is opened once
+// returns the number of files with tags (read) or updated (write)
+static int ProcessMediaFilesTags(WDL_PtrList<SNM_MediaFileTags>* _tags, bool _write)
+{
+	if (!_tags)
+		return 0;
+
+	SNM_TagsJob jobs[SNM_TAG_THREADS];
+	HANDLE threads[SNM_TAG_THREADS];
+	int nbThreads = min(SNM_TAG_THREADS, _tags->GetSize()/SNM_TAG_MIN_PER_THREAD);
+	if (nbThreads<2) nbThreads=1;
+	for (int t=0; t<nbThreads; t++)
+	{
+		jobs[t].tags = _tags;
+		jobs[t].first = t;
+		jobs[t].step = nbThreads;
+		jobs[t].write = _write;
+		threads[t] = nbThreads>1 ? (HANDLE)_beginthreadex(NULL, 0, MediaFileTagsThread, &jobs[t], 0, NULL) : NULL;
+		if (!threads[t]) // do this share on the main thread
+			MediaFileTagsThread(&jobs[t]);
+	}
+	for (int t=0; t<nbThreads; t++)
+		if (threads[t])
+		{
+			WaitForSingleObject(threads[t], INFINITE);
+			CloseHandle(threads[t]);
+		}
+
+	int cnt=0;
+	for (int i=0; i<_tags->GetSize(); i++)
+		if (_tags->Get(i) && _tags->Get(i)->m_ok)
+			cnt++;
+	return cnt;
+}
+
+int SNM_ReadMediaFilesTags(WDL_PtrList<SNM_MediaFileTags>* _tags) {
+	return ProcessMediaFilesTags(_tags, false);
+}
+
+int SNM_WriteMediaFilesTags(WDL_PtrList<SNM_MediaFileTags>* _tags) {
+	return ProcessMediaFilesTags(_tags, true);
+}
+
+// splits _str on _sep (trailing '\r' stripped), empty fields are kept except a trailing one
+static void SplitTagString(const char* _str, char _sep, WDL_PtrList_DOD<WDL_FastString>* _out)
+{
+	if (!_str || !*_str) return;
+	for (const char* p=_str; ; )
+	{
+		const char* e = strchr(p, _sep);
+		int len = e ? (int)(e-p) : (int)strlen(p);
+		if (len && p[len-1]=='\r') len--;
+		if (e || len) _out->Add(new WDL_FastString(p, len));
+		if (!e || !e[1]) break;
+		p = e+1;
+	}
+}
+
+// returns false if a tag name is unknown
+static bool GetTagIds(const char* _tagNames, WDL_TypedBuf<int>* _ids)
+{
+	WDL_PtrList_DOD<WDL_FastString> names;
+	SplitTagString(_tagNames, ',', &names);
+	for (int i=0; i<names.GetSize(); i++)
+	{
+		const char* name = names.Get(i)->Get();
+		while (*name==' ') name++;
+		int id = SNM_GetMediaFileTagId(name);
+		if (id<0) return false;
+		_ids->Add(id);
+	}
+	return _ids->GetSize()>0;
+}
+
+// ReaScript batch read: _fns and the output are one file per line, _tagNames is a comma
+// separated list of tags, each output line holds the values in that order, tab separated
+// (tabs/line breaks in values are replaced with spaces)
+int SNM_ReadMediaFilesTagsStr(const char* _fns, const char* _tagNames, char* _tagvals, int _tagvals_sz)
+{
+	if (!_tagvals || _tagvals_sz<=0) return 0;
+	*_tagvals = 0;
+
+	WDL_TypedBuf<int> ids;
+	if (!GetTagIds(_tagNames, &ids))
+		return 0;
+
+	WDL_PtrList_DOD<WDL_FastString> fns;
+	SplitTagString(_fns, '\n', &fns);
+
+	WDL_PtrList_DOD<SNM_MediaFileTags> tags;
+	for (int i=0; i<fns.GetSize(); i++)
+		tags.Add(new SNM_MediaFileTags(fns.Get(i)->Get()));
+	int cnt = SNM_ReadMediaFilesTags(&tags);
+
+	WDL_FastString out;
+	for (int i=0; i<tags.GetSize(); i++)
+	{
+		for (int j=0; j<ids.GetSize(); j++)
+		{
+			if (j) out.Append("\t");
+			int pos = out.GetLength();
+			out.Append(tags.Get(i)->m_tags[ids.Get()[j]].Get());
+			for (char* p=(char*)out.Get()+pos; *p; p++)
+				if (*p=='\t' || *p=='\n' || *p=='\r') *p=' ';
+		}
+		out.Append("\n");
+	}
+
+	// NeedBig buffer: not NUL-terminated when it fits the output exactly (see CF_GetClipboard)
+	const int len = out.GetLength();
+	realloc_cmd_ptr(&_tagvals, &_tagvals_sz, len);
+	if (_tagvals_sz > len) memcpy(_tagvals, out.Get(), len+1);
+	else memcpy(_tagvals, out.Get(), _tagvals_sz);
+	return cnt;
+}
+
+// ReaScript batch write: same formats as SNM_ReadMediaFilesTagsStr(), each line of
+// _tagvals gives the values of the related file (empty value: clears the tag)
+int SNM_TagMediaFilesStr(const char* _fns, const char* _tagNames, const char* _tagvals)
+{
+	WDL_TypedBuf<int> ids;
+	if (!GetTagIds(_tagNames, &ids))
+		return 0;
+
+	WDL_PtrList_DOD<WDL_FastString> fns, lines;
+	SplitTagString(_fns, '\n', &fns);
+	SplitTagString(_tagvals, '\n', &lines);
+
+	WDL_PtrList_DOD<SNM_MediaFileTags> tags;
+	for (int i=0; i<fns.GetSize() && i<lines.GetSize(); i++)
+	{
+		SNM_MediaFileTags* t = tags.Add(new SNM_MediaFileTags(fns.Get(i)->Get()));
+		WDL_PtrList_DOD<WDL_FastString> vals;
+		SplitTagString(lines.Get(i)->Get(), '\t', &vals);
+		for (int j=0; j<ids.GetSize(); j++)
+		{
+			t->m_tags[ids.Get()[j]].Set(j<vals.GetSize() ? vals.Get(j)->Get() : "");
+			t->m_setMask |= 1<<ids.Get()[j];
+		}
+	}
+	return SNM_WriteMediaFilesTags(&tags);
 }
 
 
@@ -476,4 +793,12 @@ void DumpActionList(COMMAND_T* _ct)
                  NULL);
 }
 
+// per task timing counters of the main thread time slice (since startup)
+void DumpTimeSliceStats(COMMAND_T*)
+{
+	WDL_FastString stats;
+	GetTimeSliceStats(&stats);
+	ShowConsoleMsg(stats.Get());
+}
+
 
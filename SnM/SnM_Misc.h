@@ -52,6 +52,36 @@ void ULT_SetMediaItemNote(MediaItem* _item, const char* _str);
 bool SNM_ReadMediaFileTag(const char *fn, const char* tag, char* tagval, int tagval_sz);
 bool SNM_TagMediaFile(const char *fn, const char* tag, const char* tagval);
 
+// media file tags
+enum {
+  SNM_TAG_ARTIST=0,
+  SNM_TAG_ALBUM,
+  SNM_TAG_GENRE,
+  SNM_TAG_COMMENT,
+  SNM_TAG_TITLE,
+  SNM_TAG_YEAR,
+  SNM_TAG_TRACK,
+  SNM_NUM_TAGS
+};
+
+// all supported tags of a media file, read or written at once
+class SNM_MediaFileTags {
+public:
+	SNM_MediaFileTags(const char* _fn = NULL) : m_fn(_fn), m_ok(false), m_setMask(0) {}
+	WDL_FastString m_fn;
+	WDL_FastString m_tags[SNM_NUM_TAGS]; // UTF-8, "" if not set
+	bool m_ok;		// read: file has tags, write: file updated
+	int m_setMask;	// write: tags to update, &(1<<SNM_TAG_xxx)
+};
+
+int SNM_GetMediaFileTagId(const char* _tag);
+bool SNM_ReadMediaFileTags(SNM_MediaFileTags* _tags);
+int SNM_ReadMediaFilesTags(WDL_PtrList<SNM_MediaFileTags>* _tags);
+bool SNM_WriteMediaFileTags(SNM_MediaFileTags* _tags);
+int SNM_WriteMediaFilesTags(WDL_PtrList<SNM_MediaFileTags>* _tags);
+int SNM_ReadMediaFilesTagsStr(const char* _fns, const char* _tagNames, char* _tagvals, int _tagvals_sz);
+int SNM_TagMediaFilesStr(const char* _fns, const char* _tagNames, const char* _tagvals);
+
 // toolbar auto refresh
 void EnableToolbarsAutoRefesh(COMMAND_T*);
 int IsToolbarsAutoRefeshEnabled(COMMAND_T*);
@@ -62,5 +92,6 @@ void ChangeMetronomeVolume(COMMAND_T*);
 void SimulateMouseClick(COMMAND_T*);
 void DumpWikiActionList(COMMAND_T*);
 void DumpActionList(COMMAND_T*);
+void DumpTimeSliceStats(COMMAND_T*);
 
 #endif
@@ -1322,64 +1322,123 @@ void NotesMarkerRegionListener::NotifyMarkerRegionUpdate(int _updateFlags)
 // import/export subtitle files, only SubRip (.srt) files atm
 // see http://en.wikipedia.org/wiki/SubRip#Specifications
 
-bool ImportSubRipFile(const char* _fn)
+// reads a whole line (whatever its length) into _line, w/o trailing "\r\n"
+// _line is reused by the caller so that parsing does not allocate per line
+static bool ReadSubRipLine(FILE* _f, WDL_FastString* _line)
+{
+	char buf[1024];
+	bool read = false;
+	_line->Set("");
+	while (fgets(buf, sizeof(buf), _f))
+	{
+		read = true;
+		_line->Append(buf);
+		int len = _line->GetLength();
+		if (len && _line->Get()[len-1] == '\n')
+			break;
+	}
+
+	int len = _line->GetLength();
+	while (len && (_line->Get()[len-1] == '\n' || _line->Get()[len-1] == '\r'))
+		len--;
+	_line->SetLen(len);
+	return read;
+}
+
+// fills a temporary id -> sub index, no dup mgmt in g_pRegionSubs (first one wins, like the notes window)
+static void GetRegionSubsById(WDL_IntKeyedArray<SNM_RegionSubtitle*>* _subs)
+{
+	for (int i=g_pRegionSubs.Get()->GetSize()-1; i>=0; i--)
+		if (SNM_RegionSubtitle* sub = g_pRegionSubs.Get()->Get(i))
+			_subs->AddUnsorted(sub->m_id, sub);
+	_subs->Resort();
+}
+
+// _errLine (optional): line number of the 1st parse error, -1 if none
+bool ImportSubRipFile(const char* _fn, int* _errLine)
 {
 	bool ok = false;
 	double firstPos = -1.0;
+	if (_errLine) *_errLine = -1;
 
 	// no need to check extension here, it's done for us
 	if (FILE* f = fopenUTF8(_fn, "rt"))
 	{
-		char buf[1024];
-		while(fgets(buf, sizeof(buf), f) && *buf)
+		WDL_IntKeyedArray<SNM_RegionSubtitle*> subs;
+		GetRegionSubsById(&subs);
+
+		WDL_FastString line, notes;
+		WDL_String name;
+		int lineNum = 0;
+
+		PreventUIRefresh(1);
+		while (ReadSubRipLine(f, &line))
 		{
-			if (int num = atoi(buf))
+			lineNum++;
+			const char* p = line.Get();
+			if (lineNum == 1 && !strncmp(p, "\xEF\xBB\xBF", 3)) // UTF-8 BOM
+				p += 3;
+
+			int num = atoi(p);
+			if (!num)
+				continue;
+
+			int p1[4], p2[4];
+			bool timing = ReadSubRipLine(f, &line);
+			lineNum++;
+			if (!timing || sscanf(line.Get(), "%d:%d:%d,%d --> %d:%d:%d,%d",
+				&p1[0], &p1[1], &p1[2], &p1[3],
+				&p2[0], &p2[1], &p2[2], &p2[3]) != 8)
 			{
-				if (fgets(buf, sizeof(buf), f) && *buf)
-				{
-					int p1[4], p2[4];
-					if (sscanf(buf, "%d:%d:%d,%d --> %d:%d:%d,%d", 
-						&p1[0], &p1[1], &p1[2], &p1[3], 
-						&p2[0], &p2[1], &p2[2], &p2[3]) != 8)
-					{
-						break;
-					}
+				if (_errLine) *_errLine = lineNum;
+				break;
+			}
 
-					WDL_FastString notes;
-					while (fgets(buf, sizeof(buf), f) && *buf) {
-						if (*buf == '\r' || *buf == '\n') break;
-						notes.Append(buf);
-					}
-          
-					WDL_String name(notes.Get());
-					char *p=name.Get();
-					while (*p) {
-						if (*p == '\r' || *p == '\n') *p=' ';
-						p++;
-					}
-					name.Ellipsize(0, 64); // 64 = native max mkr/rgn name length
+			const double pos = p1[0]*3600 + p1[1]*60 + p1[2] + double(p1[3])/1000;
+			const double end = p2[0]*3600 + p2[1]*60 + p2[2] + double(p2[3])/1000;
+			if (end < pos)
+			{
+				if (_errLine) *_errLine = lineNum;
+				break;
+			}
+
+			notes.Set("");
+			while (ReadSubRipLine(f, &line))
+			{
+				lineNum++;
+				if (!line.GetLength()) break;
+				notes.Append(line.Get());
+				notes.Append("\n");
+			}
 
-					num = AddProjectMarker(NULL, true,
-						p1[0]*3600 + p1[1]*60 + p1[2] + double(p1[3])/1000, 
-						p2[0]*3600 + p2[1]*60 + p2[2] + double(p2[3])/1000, 
-						name.Get(), num);
+			name.Set(notes.Get());
+			for (char* c=name.Get(); *c; c++)
+				if (*c == '\n') *c = ' ';
+			name.Ellipsize(0, 64); // 64 = native max mkr/rgn name length
 
-					if (num >= 0)
-					{
-						ok = true; // region added (at least)
+			num = AddProjectMarker(NULL, true, pos, end, name.Get(), num);
+			if (num >= 0)
+			{
+				ok = true; // region added (at least)
 
-						if (firstPos < 0.0)
-							firstPos = p1[0]*3600 + p1[1]*60 + p1[2] + double(p1[3])/1000;
+				if (firstPos < 0.0)
+					firstPos = pos;
 
-						int id = MakeMarkerRegionId(num, true);
-						if (id > 0) // add the sub, no duplicate mgmt..
-							g_pRegionSubs.Get()->Add(new SNM_RegionSubtitle(id, notes.Get()));
+				int id = MakeMarkerRegionId(num, true);
+				if (id > 0)
+				{
+					if (SNM_RegionSubtitle* sub = subs.Get(id, NULL))
+						sub->m_notes.Set(notes.Get());
+					else
+					{
+						sub = new SNM_RegionSubtitle(id, notes.Get());
+						g_pRegionSubs.Get()->Add(sub);
+						subs.Insert(id, sub);
 					}
 				}
-				else
-					break;
 			}
 		}
+		PreventUIRefresh(-1);
 		fclose(f);
 	}
 	
@@ -1397,24 +1456,44 @@ void ImportSubTitleFile(COMMAND_T* _ct)
 	if (char* fn = BrowseForFiles(__LOCALIZE("S&M - Import subtitle file","sws_DLG_152"), g_lastImportSubFn, NULL, false, SNM_SUB_EXT_LIST))
 	{
 		lstrcpyn(g_lastImportSubFn, fn, sizeof(g_lastImportSubFn));
-		if (ImportSubRipFile(fn))
+
+		int errLine;
+		bool ok = ImportSubRipFile(fn, &errLine);
+		if (ok)
 			//JFB hard-coded undo label: _ct might be NULL (when called from a button)
 			//    + avoid trailing "..." in undo point name (when called from an action)
 			Undo_OnStateChangeEx2(NULL, __LOCALIZE("Import subtitle file","sws_DLG_152"), UNDO_STATE_ALL, -1);
-		else
+
+		if (errLine > 0)
+		{
+			char msg[256] = "";
+			snprintf(msg, sizeof(msg), ok ?
+				__LOCALIZE_VERFMT("Subtitle file partially imported, invalid timing at line %d!","sws_DLG_152") :
+				__LOCALIZE_VERFMT("Invalid subtitle file, invalid timing at line %d!","sws_DLG_152"), errLine);
+			MessageBox(GetMainHwnd(), msg, __LOCALIZE("S&M - Error","sws_DLG_152"), MB_OK);
+		}
+		else if (!ok)
 			MessageBox(GetMainHwnd(), __LOCALIZE("Invalid subtitle file!","sws_DLG_152"), __LOCALIZE("S&M - Error","sws_DLG_152"), MB_OK);
 		free(fn);
 	}
 }
 
+// streamed to the file, subs have their own indexes
 bool ExportSubRipFile(const char* _fn)
 {
 	if (FILE* f = fopenUTF8(_fn, "wt"))
 	{
-		WDL_FastString subs;
+		WDL_IntKeyedArray<SNM_RegionSubtitle*> subs;
+		GetRegionSubsById(&subs);
+
 		int x=0, subIdx=1, num; bool isRgn; double p1, p2;
 		while ((x = EnumProjectMarkers2(NULL, x, &isRgn, &p1, &p2, NULL, &num)))
 		{
+			int id = MakeMarkerRegionId(num, isRgn);
+			SNM_RegionSubtitle* rn = id > 0 ? subs.Get(id, NULL) : NULL;
+			if (!rn)
+				continue;
+
 			// special case for markers: end position = next start position
 			if (!isRgn)
 			{
@@ -1423,37 +1502,18 @@ bool ExportSubRipFile(const char* _fn)
 					p2 = p1 + 5.0; // best effort..
 			}
 
-			int id = MakeMarkerRegionId(num, isRgn);
-			if (id > 0)
-			{
-				for (int i=0; i < g_pRegionSubs.Get()->GetSize(); i++)
-				{
-					SNM_RegionSubtitle* rn = g_pRegionSubs.Get()->Get(i);
-					if (rn->m_id == id)
-					{
-						subs.AppendFormatted(64, "%d\n", subIdx++); // subs have their own indexes
-						
-						int h, m, s, ms;
-						TranslatePos(p1, &h, &m, &s, &ms);
-						subs.AppendFormatted(64,"%02d:%02d:%02d,%03d --> ",h,m,s,ms);
-						TranslatePos(p2, &h, &m, &s, &ms);
-						subs.AppendFormatted(64,"%02d:%02d:%02d,%03d\n",h,m,s,ms);
-
-						subs.Append(rn->m_notes.Get());
-						if (rn->m_notes.GetLength() && rn->m_notes.Get()[rn->m_notes.GetLength()-1] != '\n')
-							subs.Append("\n");
-						subs.Append("\n");
-					}
-				}
-			}
-		}
+			int h1, m1, s1, ms1, h2, m2, s2, ms2;
+			TranslatePos(p1, &h1, &m1, &s1, &ms1);
+			TranslatePos(p2, &h2, &m2, &s2, &ms2);
+			fprintf(f, "%d\n%02d:%02d:%02d,%03d --> %02d:%02d:%02d,%03d\n", subIdx++, h1, m1, s1, ms1, h2, m2, s2, ms2);
 
-		if (subs.GetLength())
-		{
-			fputs(subs.Get(), f);
-			fclose(f);
-			return true;
+			fputs(rn->m_notes.Get(), f);
+			if (rn->m_notes.GetLength() && rn->m_notes.Get()[rn->m_notes.GetLength()-1] != '\n')
+				fputs("\n", f);
+			fputs("\n", f);
 		}
+		fclose(f);
+		return subIdx > 1;
 	}
 	return false;
 }
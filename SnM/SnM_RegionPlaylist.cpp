@@ -104,6 +104,7 @@ bool g_monitorMode = false;
 bool g_repeatPlaylist = false;	// playlist repeat state
 bool g_seekImmediate = false;
 int g_optionFlags = false;
+int g_lookaheadBlocks = 0;		// lookahead (in audio blocks) when comparing the play position with the next region
 
 // see PlaylistRun()
 int g_playPlaylist = -1;		// -1: stopped, playlist id otherwise
@@ -120,6 +121,12 @@ int g_oldSeekPref = -1;
 int g_oldStopprojlenPref = -1;
 int g_oldRepeatState = -1;
 
+double g_lookahead = 0.0;		// g_lookaheadBlocks in seconds, see UpdatePlaylistLookahead()
+
+// region switch instrumentation: play position error (s) when switches are detected
+int g_switchCnt = 0;
+double g_switchErr = 0.0, g_switchMaxErr = 0.0;
+
 
 // _plId: -1 for the displayed/edited playlist
 RegionPlaylist* GetPlaylist(int _plId = -1) {
@@ -133,7 +140,7 @@ RegionPlaylist* GetPlaylist(int _plId = -1) {
 ///////////////////////////////////////////////////////////////////////////////
 
 RegionPlaylist::RegionPlaylist(RegionPlaylist* _pl, const char* _name)
-	: m_name(_name), WDL_PtrList<RgnPlaylistItem>()
+	: m_name(_name), m_resolvedProj(NULL), WDL_PtrList<RgnPlaylistItem>()
 {
 	if (_pl)
 	{
@@ -144,90 +151,145 @@ RegionPlaylist::RegionPlaylist(RegionPlaylist* _pl, const char* _name)
 	}
 }
 
+// resolve all playlist items against project markers/regions at once (rather than enumerating
+// markers/regions per item), the result is cached until the project, its markers/regions or
+// the playlist change
+const RgnPlaylistResolvedItem* RegionPlaylist::Resolve()
+{
+	ReaProject* proj = EnumProjects(-1, NULL, 0);
+	int stateCnt = GetProjectStateChangeCount(proj);
+	int mkrRgnCnt = GetMarkerRegionUpdateCount();
+
+	bool upToDate = (m_resolvedProj==proj && m_resolvedStateCnt==stateCnt && 
+		m_resolvedMkrRgnCnt==mkrRgnCnt && m_resolved.GetSize()==GetSize());
+	for (int i=0; upToDate && i<GetSize(); i++)
+	{
+		RgnPlaylistItem* plItem = Get(i);
+		const RgnPlaylistResolvedItem* r = m_resolved.Get()+i;
+		upToDate = (plItem==r->m_item && (!plItem || (plItem->m_rgnId==r->m_rgnId && plItem->m_cnt==r->m_cnt)));
+	}
+	if (upToDate)
+		return m_resolved.Get();
+
+	m_resolvedProj = proj;
+	m_resolvedStateCnt = stateCnt;
+	m_resolvedMkrRgnCnt = mkrRgnCnt;
+
+	// 1st marker/region wins for a given id, like EnumMarkerRegionById()
+	map<int,int> idxById;
+	m_mkrRgnPos.Resize(0, false);
+	m_rgnEnds.Resize(0, false);
+	WDL_TypedBuf<int> nums;
+	WDL_TypedBuf<double> ends;
+	int x=0, num; double pos, end; bool isRgn;
+	while ((x = EnumProjectMarkers3(proj, x, &isRgn, &pos, &end, NULL, &num, NULL)))
+	{
+		idxById.insert(make_pair(MakeMarkerRegionId(num, isRgn), m_mkrRgnPos.GetSize()));
+		m_mkrRgnPos.Add(pos);
+		ends.Add(end);
+		nums.Add(num);
+		if (isRgn)
+			m_rgnEnds.Add(end);
+	}
+
+	m_resolved.Resize(GetSize(), false);
+	m_lengths.Resize(GetSize()+1, false);
+	m_lengths.Get()[0] = 0.0;
+	m_infinite = false;
+	for (int i=0; i<GetSize(); i++)
+	{
+		RgnPlaylistItem* plItem = Get(i);
+		RgnPlaylistResolvedItem* r = m_resolved.Get()+i;
+		r->m_item = plItem;
+		r->m_rgnId = plItem ? plItem->m_rgnId : -1;
+		r->m_cnt = plItem ? plItem->m_cnt : 0;
+		r->m_num = -1;
+		r->m_pos = r->m_end = 0.0;
+
+		map<int,int>::iterator it = r->m_rgnId>0 ? idxById.find(r->m_rgnId) : idxById.end();
+		if (it != idxById.end())
+		{
+			r->m_num = nums.Get()[it->second];
+			r->m_pos = m_mkrRgnPos.Get()[it->second];
+			r->m_end = ends.Get()[it->second];
+		}
+		r->m_valid = (r->m_rgnId>0 && r->m_cnt!=0 && r->m_num>=0);
+
+		m_lengths.Get()[i+1] = m_lengths.Get()[i];
+		if (r->m_valid)
+		{
+			m_infinite |= r->m_cnt<0;
+			m_lengths.Get()[i+1] += ((r->m_end-r->m_pos) * abs(r->m_cnt));
+		}
+	}
+
+	std::sort(m_mkrRgnPos.Get(), m_mkrRgnPos.Get()+m_mkrRgnPos.GetSize());
+	std::sort(m_rgnEnds.Get(), m_rgnEnds.Get()+m_rgnEnds.GetSize());
+
+	return m_resolved.Get();
+}
+
 bool RegionPlaylist::IsValidIem(int _i)
 {
-	if (RgnPlaylistItem* item = Get(_i))
-		return item->IsValidIem();
+	if (_i>=0 && _i<GetSize())
+		return Resolve()[_i].m_valid;
 	return false;
 }
 
 // return the first found playlist idx for _pos
 int RegionPlaylist::IsInPlaylist(double _pos, bool _repeat, int _startWith)
 {
-	double rgnpos, rgnend;
+	const RgnPlaylistResolvedItem* items = Resolve();
 	for (int i=_startWith; i<GetSize(); i++)
-		if (RgnPlaylistItem* plItem = Get(i))
-			if (plItem->m_rgnId>0 && plItem->m_cnt!=0 && EnumMarkerRegionById(NULL, plItem->m_rgnId, NULL, &rgnpos, &rgnend, NULL, NULL, NULL)>=0)
-				if (_pos >= rgnpos && _pos <= rgnend)
-					return i;
+		if (items[i].m_valid && _pos >= items[i].m_pos && _pos <= items[i].m_end)
+			return i;
 	// 2nd try
 	if (_repeat)
-		for (int i=0; i<_startWith; i++)
-			if (RgnPlaylistItem* plItem = Get(i))
-				if (plItem->m_rgnId>0 && plItem->m_cnt!=0 && EnumMarkerRegionById(NULL, plItem->m_rgnId, NULL, &rgnpos, &rgnend, NULL, NULL, NULL)>=0)
-					if (_pos >= rgnpos && _pos <= rgnend)
-						return i;
+		for (int i=0; i<_startWith && i<GetSize(); i++)
+			if (items[i].m_valid && _pos >= items[i].m_pos && _pos <= items[i].m_end)
+				return i;
 	return -1;
 }
 
 int RegionPlaylist::IsInfinite()
 {
-	int num;
+	const RgnPlaylistResolvedItem* items = Resolve();
 	for (int i=0; i<GetSize(); i++)
-		if (RgnPlaylistItem* plItem = Get(i))
-			if (plItem->m_rgnId>0 && plItem->m_cnt<0 && EnumMarkerRegionById(NULL, plItem->m_rgnId, NULL, NULL, NULL, NULL, &num, NULL)>=0)
-				return num;
+		if (items[i].m_valid && items[i].m_cnt<0)
+			return items[i].m_num;
 	return -1;
 }
 
 // returns playlist length is seconds, with a negative value if it contains infinite loops
 double RegionPlaylist::GetLength()
 {
-	bool infinite = false;
-	double length=0.0;
-	for (int i=0; i<GetSize(); i++)
-	{
-		double rgnpos, rgnend;
-		if (RgnPlaylistItem* plItem = Get(i))
-		{
-			if (plItem->m_rgnId>0 && plItem->m_cnt!=0 && EnumMarkerRegionById(NULL, plItem->m_rgnId, NULL, &rgnpos, &rgnend, NULL, NULL, NULL)>=0) {
-				infinite |= plItem->m_cnt<0;
-				length += ((rgnend-rgnpos) * abs(plItem->m_cnt));
-			}
-		}
-	}
-	return infinite ? length*(-1) : length;
+	Resolve();
+	double length = m_lengths.Get()[GetSize()];
+	return m_infinite ? length*(-1) : length;
 }
 
 // get the 1st marker/region num which has nested marker/region
 int RegionPlaylist::GetNestedMarkerRegion()
 {
+	const RgnPlaylistResolvedItem* items = Resolve();
+	const double* posBeg = m_mkrRgnPos.Get();
+	const double* posEnd = posBeg + m_mkrRgnPos.GetSize();
+	const double* endBeg = m_rgnEnds.Get();
+	const double* endEnd = endBeg + m_rgnEnds.GetSize();
 	for (int i=0; i<GetSize(); i++)
 	{
-		if (RgnPlaylistItem* plItem = Get(i))
+		if (items[i].m_num>=0)
 		{
-			double rgnpos, rgnend;
-			int num, rgnidx = EnumMarkerRegionById(NULL, plItem->m_rgnId, NULL, &rgnpos, &rgnend, NULL, &num, NULL);
-			if (rgnidx>=0)
-			{
-				int x=0, lastx=0; double dPos, dEnd; bool isRgn;
-				while ((x = EnumProjectMarkers2(NULL, x, &isRgn, &dPos, &dEnd, NULL, NULL)))
-				{
-					if (rgnidx != lastx)
-					{
-						if (isRgn)
-						{
-							// issue 613 => use SNM_FUDGE_FACTOR to skip adjacent regions
-							if ((dPos>=(rgnpos+SNM_FUDGE_FACTOR) && dPos<=(rgnend-SNM_FUDGE_FACTOR)) || 
-								(dEnd>=(rgnpos+SNM_FUDGE_FACTOR) && dEnd<=(rgnend-SNM_FUDGE_FACTOR)))
-								return num;
-						}
-						else if (dPos>=(rgnpos+SNM_FUDGE_FACTOR) && dPos<=(rgnend-SNM_FUDGE_FACTOR))
-							return num;
-					}
-					lastx=x;
-				}
-			}
+			// issue 613 => use SNM_FUDGE_FACTOR to skip adjacent regions (and the region itself)
+			double lo = items[i].m_pos+SNM_FUDGE_FACTOR, hi = items[i].m_end-SNM_FUDGE_FACTOR;
+			if (lo > hi)
+				continue;
+			const double* p = std::lower_bound(posBeg, posEnd, lo);
+			if (p != posEnd && *p <= hi)
+				return items[i].m_num;
+			p = std::lower_bound(endBeg, endEnd, lo);
+			if (p != endEnd && *p <= hi)
+				return items[i].m_num;
 		}
 	}
 	return -1;
@@ -236,13 +298,10 @@ int RegionPlaylist::GetNestedMarkerRegion()
 // get the 1st marker/region num which has a marker/region > _pos
 int RegionPlaylist::GetGreaterMarkerRegion(double _pos)
 {
+	const RgnPlaylistResolvedItem* items = Resolve();
 	for (int i=0; i<GetSize(); i++)
-		if (RgnPlaylistItem* plItem = Get(i))
-		{
-			double rgnpos; int num;
-			if (EnumMarkerRegionById(NULL, plItem->m_rgnId, NULL, &rgnpos, NULL, NULL, &num, NULL)>=0 && rgnpos>_pos)
-				return num;
-		}
+		if (items[i].m_num>=0 && items[i].m_pos>_pos)
+			return items[i].m_num;
 	return -1;
 }
 
@@ -1195,7 +1254,17 @@ bool RegionPlaylistWnd::GetToolTipString(int _xpos, int _ypos, char* _bufOut, in
 				lstrcpyn(_bufOut, __LOCALIZE("Toggle monitoring/edition mode","sws_DLG_165"), _bufOutSz);
 				return true;
 			case BTNID_PLAY:
-				if (g_playPlaylist>=0) snprintf(_bufOut, _bufOutSz, __LOCALIZE_VERFMT("Playing playlist #%d","sws_DLG_165"), g_playPlaylist+1);
+				if (g_playPlaylist>=0)
+				{
+					snprintf(_bufOut, _bufOutSz, __LOCALIZE_VERFMT("Playing playlist #%d","sws_DLG_165"), g_playPlaylist+1);
+					if (g_switchCnt)
+					{
+						char buf[256]="\n";
+						snprintf(buf+1, sizeof(buf)-1, __LOCALIZE_VERFMT("Region switches: %d (last error: %.1f ms, max: %.1f ms)","sws_DLG_165"), g_switchCnt, g_switchErr*1000.0, g_switchMaxErr*1000.0);
+						if ((int)(strlen(_bufOut)+strlen(buf)) < _bufOutSz)
+							strcat(_bufOut, buf);
+					}
+				}
 				else lstrcpyn(_bufOut, __LOCALIZE("Play","sws_DLG_165"), _bufOutSz);
 				return true;
 			case BTNID_STOP:
@@ -1262,12 +1331,13 @@ int GetNextValidItem(int _plId, int _itemId, bool _startWith, bool _repeat)
 	{
 		if (RegionPlaylist* pl = GetPlaylist(_plId))
 		{
+			const RgnPlaylistResolvedItem* items = pl->Resolve();
 			for (int i=_itemId+(_startWith?0:1); i<pl->GetSize(); i++)
-				if (pl->IsValidIem(i))
+				if (items[i].m_valid)
 					return i;
 			if (_repeat)
 				for (int i=0; i<pl->GetSize() && i<(_itemId+(_startWith?1:0)); i++)
-					if (pl->IsValidIem(i))
+					if (items[i].m_valid)
 						return i;
 			// not found if we are here..
 			if (_repeat && pl->IsValidIem(_itemId))
@@ -1284,12 +1354,13 @@ int GetPrevValidItem(int _plId, int _itemId, bool _startWith, bool _repeat)
 	{
 		if (RegionPlaylist* pl = GetPlaylist(_plId))
 		{
-			for (int i=_itemId-(_startWith?0:1); i>=0; i--)
-				if (pl->IsValidIem(i))
+			const RgnPlaylistResolvedItem* items = pl->Resolve();
+			for (int i=min(_itemId-(_startWith?0:1), pl->GetSize()-1); i>=0; i--)
+				if (items[i].m_valid)
 					return i;
 			if (_repeat)
 				for (int i=pl->GetSize()-1; i>=0 && i>(_itemId-(_startWith?1:0)); i--)
-					if (pl->IsValidIem(i))
+					if (items[i].m_valid)
 						return i;
 			// not found if we are here..
 			if (_repeat && pl->IsValidIem(_itemId))
@@ -1318,16 +1389,17 @@ bool SeekItem(int _plId, int _nextItemId, int _curItemId)
 			SeekPlay(g_nextRgnPos);
 			return true;
 		}
-		else if (RgnPlaylistItem* next = pl->Get(_nextItemId))
+		else if (_nextItemId<pl->GetSize() && pl->Get(_nextItemId))
 		{
-			double a, b;
-			if (EnumMarkerRegionById(NULL, next->m_rgnId, NULL, &a, &b, NULL, NULL, NULL)>=0)
+			// seek points come from the resolved playlist, no marker/region lookup here
+			const RgnPlaylistResolvedItem* next = pl->Resolve()+_nextItemId;
+			if (next->m_num>=0)
 			{
 				g_playNext = _nextItemId;
 				g_playCur = _plId==g_playPlaylist ? g_playCur : _curItemId;
 				g_rgnLoop = next->m_cnt<0 ? -1 : next->m_cnt>1 ? next->m_cnt : 0;
-				g_nextRgnPos = a;
-				g_nextRgnEnd = b;
+				g_nextRgnPos = next->m_pos;
+				g_nextRgnEnd = next->m_end;
 				if (_curItemId<0) {
 					g_curRgnPos = 0.0;
 					g_curRgnEnd = -1.0;
@@ -1340,6 +1412,20 @@ bool SeekItem(int _plId, int _nextItemId, int _curItemId)
 	return false;
 }
 
+// lookahead in seconds, from the audio device block size (no lookahead if unknown)
+void UpdatePlaylistLookahead()
+{
+	g_lookahead = 0.0;
+	char bsize[32]="", srate[32]="";
+	if (g_lookaheadBlocks>0 && GetAudioDeviceInfo &&
+		GetAudioDeviceInfo("BSIZE", bsize, sizeof(bsize)) && GetAudioDeviceInfo("SRATE", srate, sizeof(srate)))
+	{
+		double bs = atof(bsize), sr = atof(srate);
+		if (bs>0.0 && sr>0.0)
+			g_lookahead = g_lookaheadBlocks * bs / sr;
+	}
+}
+
 // the meat!
 // polls the playing position and smooth seeks if needed
 // remember we always lookup one region ahead!
@@ -1354,13 +1440,13 @@ void PlaylistRun()
 		bool updated = false;
 		double pos = GetPlayPosition2Ex(NULL);
 
-		// NF: potentially fix #886
-		// it seems that if '+0.01' isn't added to 'pos' below, adjacent regions are no more occassionally skipped
-		// https://forum.cockos.com/showpost.php?p=1935561&postcount=6 and my own tests so far seem to confirm also
-		// but I'm unsure what poetential side effects this might have
-		if ((pos/*+0.01*/) >= g_nextRgnPos && pos <= g_nextRgnEnd)	//JFB!! +0.01 because 'pos' can be a bit ahead of time
-																// +1 sample block would be better, but no API..
-																// note: sync loss detection will deal with this in the worst case
+		// next region detection: 'pos' is compared as is while in the region being played, any lookahead
+		// there would trigger the next seek early and skip adjacent regions (#886, see
+		// https://forum.cockos.com/showpost.php?p=1935561&postcount=6)
+		// out of it (e.g. waiting for a smooth seek), 'pos' is advanced by the lookahead (audio blocks,
+		// see UpdatePlaylistLookahead(), 0 by default) so that the switch is planned ahead of time
+		bool inCurRgn = (g_curRgnPos<g_curRgnEnd && pos>=g_curRgnPos && pos<=g_curRgnEnd);
+		if ((pos+(inCurRgn?0.0:g_lookahead)) >= g_nextRgnPos && pos <= g_nextRgnEnd) // note: sync loss detection will deal with this in the worst case
 		{
 			// a bunch of calls end here when looping!!
 
@@ -1387,6 +1473,15 @@ void PlaylistRun()
 					g_playCur = g_playNext;
 					g_curRgnPos = g_nextRgnPos;
 					g_curRgnEnd = g_nextRgnEnd;
+
+					// instrumentation: how far from the region start this switch has been detected
+					g_switchCnt++;
+					g_switchErr = pos-g_curRgnPos;
+					if (fabs(g_switchErr) > fabs(g_switchMaxErr))
+						g_switchMaxErr = g_switchErr;
+#ifdef _SNM_RGNPL_DEBUG1
+					snprintf(dbg, sizeof(dbg), "                switch error = %f\n", g_switchErr); OutputDebugString(dbg);
+#endif
 				}
 
 				// region loop?
@@ -1425,8 +1520,7 @@ void PlaylistRun()
 		else if (g_curRgnPos<g_curRgnEnd) // relevant vars?
 		{
 			// seek play requested, waiting for region switch..
-			if ((pos+0.01) >= g_curRgnPos && pos <= g_curRgnEnd) //JFB!! +0.01 because 'pos' can be a bit ahead of time
-																 // +1 sample block would be better, but no API..
+			if ((pos+max(0.01,g_lookahead)) >= g_curRgnPos && pos <= g_curRgnEnd) //JFB!! +0.01 because 'pos' can be a bit ahead of time
 			{
 				// a bunch of calls end here!
 				g_unsync = false;
@@ -1556,6 +1650,11 @@ void PlaylistPlay(int _plId, int _itemId)
 			g_plLoop = false;
 			g_unsync = false;
 			g_lastRunPos = SNM_GetProjectLength()+1.0;
+			if (g_playPlaylist<0) {
+				g_switchCnt = 0;
+				g_switchErr = g_switchMaxErr = 0.0;
+			}
+			UpdatePlaylistLookahead();
 			if (SeekItem(_plId, _itemId, g_playPlaylist==_plId ? g_playCur : -1))
 			{
 				g_playPlaylist = _plId; // enables PlaylistRun()
@@ -2086,6 +2185,8 @@ int RegionPlaylistInit()
 	g_repeatPlaylist = (GetPrivateProfileInt("RegionPlaylist", "Repeat", 0, g_SNM_IniFn.Get()) == 1);
 	g_seekImmediate = (GetPrivateProfileInt("RegionPlaylist", "SeekImmediate", 0, g_SNM_IniFn.Get()) == 1);
 	g_optionFlags = (GetPrivateProfileInt("RegionPlaylist", "SeekPlay", 0, g_SNM_IniFn.Get()) == 1);
+	g_lookaheadBlocks = GetPrivateProfileInt("RegionPlaylist", "LookaheadBlocks", 0, g_SNM_IniFn.Get());
+	g_lookaheadBlocks = BOUNDED(g_lookaheadBlocks, 0, 16);
 	GetPrivateProfileString("RegionPlaylist", "BigFontName", SNM_DYN_FONT_NAME, g_rgnplBigFontName, sizeof(g_rgnplBigFontName), g_SNM_IniFn.Get());
 	GetPrivateProfileString("RegionPlaylist", "OscFeedback", "", buf, sizeof(buf), g_SNM_IniFn.Get());
 	g_osc = LoadOscCSurfs(NULL, buf); // NULL on err (e.g. "", token doesn't exist, etc.)
@@ -2109,6 +2210,9 @@ void RegionPlaylistExit()
 	WritePrivateProfileString("RegionPlaylist", "ScrollView", NULL, g_SNM_IniFn.Get()); // deprecated
 	WritePrivateProfileString("RegionPlaylist", "SeekImmediate", g_seekImmediate?"1":"0", g_SNM_IniFn.Get());
 	WritePrivateProfileString("RegionPlaylist", "SeekPlay", g_optionFlags?"1":"0", g_SNM_IniFn.Get()); 
+	char buf[16]="";
+	snprintf(buf, sizeof(buf), "%d", g_lookaheadBlocks);
+	WritePrivateProfileString("RegionPlaylist", "LookaheadBlocks", g_lookaheadBlocks>0 ? buf : NULL, g_SNM_IniFn.Get()); // hidden pref
 	WritePrivateProfileString("RegionPlaylist", "BigFontName", g_rgnplBigFontName, g_SNM_IniFn.Get());
 	if (g_osc)
 	{
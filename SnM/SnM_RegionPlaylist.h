@@ -49,11 +49,21 @@ public:
 	int m_rgnId, m_cnt;
 };
 
+// playlist item resolved against project markers/regions, see RegionPlaylist::Resolve()
+struct RgnPlaylistResolvedItem {
+	RgnPlaylistItem* m_item; // m_item, m_rgnId and m_cnt: state of the playlist item when resolved
+	int m_rgnId, m_cnt;
+	int m_num; // marker/region number, -1 if not found in the project
+	double m_pos, m_end;
+	bool m_valid; // see RgnPlaylistItem::IsValidIem()
+};
+
 class RegionPlaylist : public WDL_PtrList<RgnPlaylistItem> {
 public:
 	RegionPlaylist(RegionPlaylist* _pl = NULL, const char* _name = NULL);
-	RegionPlaylist(const char* _name) : m_name(_name), WDL_PtrList<RgnPlaylistItem>() {}
+	RegionPlaylist(const char* _name) : m_name(_name), m_resolvedProj(NULL), WDL_PtrList<RgnPlaylistItem>() {}
 	~RegionPlaylist() {}
+	const RgnPlaylistResolvedItem* Resolve();
 	bool IsValidIem(int _i);
 	int IsInPlaylist(double _pos, bool _repeat, int _startWith);
 	int IsInfinite();
@@ -61,6 +71,13 @@ public:
 	int GetNestedMarkerRegion();
 	int GetGreaterMarkerRegion(double _pos);
 	WDL_FastString m_name;
+protected:
+	WDL_TypedBuf<RgnPlaylistResolvedItem> m_resolved;
+	WDL_TypedBuf<double> m_lengths; // prefix sums: m_lengths[i] = length of items [0,i[
+	WDL_TypedBuf<double> m_mkrRgnPos, m_rgnEnds; // sorted, for GetNestedMarkerRegion()
+	bool m_infinite;
+	ReaProject* m_resolvedProj;
+	int m_resolvedStateCnt, m_resolvedMkrRgnCnt;
 };
 
 class RegionPlaylists : public WDL_PtrList<RegionPlaylist>
@@ -53,6 +53,7 @@
 #define RES_INI_SEC					"Resources"
 
 #define RES_TIE_TAG					" [x]" //UTF8_BULLET
+#define SNM_RES_PRELOAD_SLOTS		2
 
 
 enum {
@@ -274,6 +275,22 @@ int GetTypeForUser(int _type = -1)
 	return _type;
 }
 
+// preload FX chain/track template files of the next slots (auditioning slots one after
+// the other), so that applying them is served from memory, see LoadChunkCached()
+void PreloadSlots(int _type, int _slot)
+{
+	int typeForUser = GetTypeForUser(_type);
+	if (typeForUser!=SNM_SLOT_FXC && typeForUser!=SNM_SLOT_TR)
+		return;
+	if (ResourceList* fl = g_SNM_ResSlots.Get(_type))
+	{
+		char fn[SNM_MAX_PATH]="";
+		for (int i=_slot; i>=0 && i<fl->GetSize() && i<=_slot+SNM_RES_PRELOAD_SLOTS; i++)
+			if (!fl->Get(i)->IsDefault() && fl->GetFullPath(i, fn, sizeof(fn)))
+				PreloadChunk(fn);
+	}
+}
+
 bool IsMultiType(int _type = -1)
 {
 	if (_type < 0) _type = g_resType;
@@ -721,6 +738,13 @@ void ResourcesView::SetItemText(SWS_ListItem* item, int iCol, const char* str)
 	}
 }
 
+void ResourcesView::OnItemSelChanged(SWS_ListItem* item, int iState)
+{
+	if (iState & LVIS_FOCUSED)
+		if (ResourceList* fl = g_SNM_ResSlots.Get(g_resType))
+			PreloadSlots(g_resType, fl->Find((ResourceItem*)item));
+}
+
 void ResourcesView::OnItemDblClk(SWS_ListItem* item, int iCol) {
 	Perform(g_dblClickPrefs[g_resType]);
 }
@@ -3685,7 +3709,7 @@ void ApplyTracksFXChainSlot(int _slotType, const char* _title, int _slot, bool _
 	if (fnStr && SNM_CountSelectedTracks(NULL, true))
 	{
 		WDL_FastString chain;
-		if (LoadChunk(fnStr->Get(), &chain))
+		if (LoadChunkCached(fnStr->Get(), &chain))
 		{
 			// remove all fx param envelopes
 			// (were saved for track fx chains before SWS v2.1.0 #11)
@@ -3695,6 +3719,7 @@ void ApplyTracksFXChainSlot(int _slotType, const char* _title, int _slot, bool _
 			}
 			if (_set) SetTrackFXChain(_title, &chain, _inputFX);
 			else  PasteTrackFXChain(_title, &chain, _inputFX);
+			PreloadSlots(_slotType, _slot+1);
 		}
 		delete fnStr;
 	}
@@ -3774,7 +3799,7 @@ void ApplyTakesFXChainSlot(int _slotType, const char* _title, int _slot, bool _a
 	if (fnStr && CountSelectedMediaItems(NULL))
 	{
 		WDL_FastString chain;
-		if (LoadChunk(fnStr->Get(), &chain))
+		if (LoadChunkCached(fnStr->Get(), &chain))
 		{
 			// remove all fx param envelopes
 			// (were saved for track fx chains before SWS v2.1.0 #11)
@@ -3784,6 +3809,7 @@ void ApplyTakesFXChainSlot(int _slotType, const char* _title, int _slot, bool _a
 			}
 			if (_set) SetTakeFXChain(_title, &chain, _activeOnly);
 			else PasteTakeFXChain(_title, &chain, _activeOnly);
+			PreloadSlots(_slotType, _slot+1);
 		}
 		delete fnStr;
 	}
@@ -3866,7 +3892,7 @@ void ApplyTrackTemplateSlot(int _slotType, const char* _title, int _slot, bool _
 	if (WDL_FastString* fnStr = GetOrPromptOrBrowseSlot(_slotType, &_slot))
 	{
 		WDL_FastString tmpltFile;
-		if (SNM_CountSelectedTracks(NULL, true) && LoadChunk(fnStr->Get(), &tmpltFile) && tmpltFile.GetLength())
+		if (SNM_CountSelectedTracks(NULL, true) && LoadChunkCached(fnStr->Get(), &tmpltFile) && tmpltFile.GetLength())
 		{
 			int tmpltIdx=0, tmpltIdxMax=0xFFFFFF; // trick to avoid useless calls to MakeSingleTrackTemplateChunk()
 			WDL_PtrList_DeleteOnDestroy<WDL_FastString> tmplts; // cache
@@ -3899,6 +3925,7 @@ void ApplyTrackTemplateSlot(int _slotType, const char* _title, int _slot, bool _
 						updated |= ApplyTrackTemplate(tr, tmplt, _itemsFromTmplt, _envsFromTmplt);
 						tmpltIdx++;
 					}
+			PreloadSlots(_slotType, _slot+1);
 		}
 		delete fnStr;
 	}
@@ -3924,7 +3951,7 @@ void ReplacePasteItemsTrackTemplateSlot(int _slotType, const char* _title, int _
 	if (WDL_FastString* fnStr = GetOrPromptOrBrowseSlot(_slotType, &_slot))
 	{
 		WDL_FastString tmpltFile;
-		if (CountSelectedTracks(NULL) && LoadChunk(fnStr->Get(), &tmpltFile) && tmpltFile.GetLength())
+		if (CountSelectedTracks(NULL) && LoadChunkCached(fnStr->Get(), &tmpltFile) && tmpltFile.GetLength())
 		{
 			int tmpltIdx=0, tmpltIdxMax=0xFFFFFF; // trick to avoid useless calls to GetItemsSubChunk()
 			WDL_PtrList_DeleteOnDestroy<WDL_FastString> tmplts; // cache
@@ -3956,6 +3983,7 @@ void ReplacePasteItemsTrackTemplateSlot(int _slotType, const char* _title, int _
 						updated |= ReplacePasteItemsFromTrackTemplate(tr, tmpltItems, _paste);
 						tmpltIdx++;
 					}
+			PreloadSlots(_slotType, _slot+1);
 		}
 		delete fnStr;
 	}
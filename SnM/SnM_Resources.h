@@ -114,6 +114,7 @@ protected:
 	void GetItemText(SWS_ListItem* item, int iCol, char* str, int iStrMax);
 	bool IsEditListItemAllowed(SWS_ListItem* item, int iCol);
 	void SetItemText(SWS_ListItem* item, int iCol, const char* str);
+	void OnItemSelChanged(SWS_ListItem* item, int iState);
 	void OnItemDblClk(SWS_ListItem* item, int iCol);
 	void GetItemList(SWS_ListItemList* pList);
 	void OnBeginDrag(SWS_ListItem* item);
@@ -298,11 +298,219 @@ bool LoadChunk(const char* _fn, WDL_FastString* _chunkOut, bool _trim, int _appr
 	return false;
 }
 
+
+///////////////////////////////////////////////////////////////////////////////
+// Chunk file cache: bounded LRU of trimmed chunks (as returned by LoadChunk()),
+// validated against file size/date on each access, files can be preloaded
+// by a worker thread (e.g. S&M Resources FX chain/track template slots)
+///////////////////////////////////////////////////////////////////////////////
+
+#define SNM_CHUNK_CACHE_MAX_FILES	64
+#define SNM_CHUNK_CACHE_MAX_SIZE	(32*1024*1024)
+#define SNM_CHUNK_PRELOAD_MAX		16
+
+struct SNM_CachedChunk
+{
+	WDL_FastString fn, chunk;
+	time_t mtime;
+	WDL_INT64 size;
+	unsigned int lastUse;
+};
+
+static SWS_Mutex g_chunkCacheMutex;
+static WDL_PtrList_DOD<SNM_CachedChunk> g_chunkCache;
+static WDL_PtrList_DOD<WDL_FastString> g_chunkPreloadQueue;
+static unsigned int g_chunkCacheClock = 0;
+static bool g_chunkPreloading = false, g_chunkPreloadExit = false;
+
+// file date/size, used to validate file caches
+bool GetFileStamp(const char* _fn, time_t* _mtime, WDL_INT64* _size)
+{
+	struct stat s;
+#ifdef _WIN32
+	if (statUTF8(_fn, &s)) return false;
+#else
+	if (stat(_fn, &s)) return false;
+#endif
+	*_mtime = s.st_mtime;
+	*_size = (WDL_INT64)s.st_size;
+	return true;
+}
+
+// lock must be held
+static int FindCachedChunk(const char* _fn)
+{
+	for (int i=0; i<g_chunkCache.GetSize(); i++)
+		if (!strcmp(g_chunkCache.Get(i)->fn.Get(), _fn))
+			return i;
+	return -1;
+}
+
+// lock must be held
+static void AddCachedChunk(const char* _fn, WDL_FastString* _chunk, time_t _mtime, WDL_INT64 _size)
+{
+	int idx = FindCachedChunk(_fn);
+	if (idx>=0) g_chunkCache.Delete(idx, true);
+
+	if (_chunk->GetLength() > SNM_CHUNK_CACHE_MAX_SIZE/4)
+		return; // not worth evicting everything else
+
+	SNM_CachedChunk* c = new SNM_CachedChunk;
+	c->fn.Set(_fn);
+	c->chunk.Set(_chunk);
+	c->mtime = _mtime;
+	c->size = _size;
+	c->lastUse = ++g_chunkCacheClock;
+	g_chunkCache.Add(c);
+
+	// evict least recently used entries
+	for (;;)
+	{
+		int total=0, lru=-1;
+		for (int i=0; i<g_chunkCache.GetSize(); i++)
+		{
+			total += g_chunkCache.Get(i)->chunk.GetLength();
+			if (lru<0 || g_chunkCache.Get(i)->lastUse < g_chunkCache.Get(lru)->lastUse)
+				lru = i;
+		}
+		if (lru<0 || (g_chunkCache.GetSize()<=SNM_CHUNK_CACHE_MAX_FILES && total<=SNM_CHUNK_CACHE_MAX_SIZE))
+			break;
+		g_chunkCache.Delete(lru, true);
+	}
+}
+
+// same as LoadChunk(_fn, _chunkOut, true) but served from the cache when the file is unchanged
+bool LoadChunkCached(const char* _fn, WDL_FastString* _chunkOut)
+{
+	if (!_chunkOut || !_fn || !*_fn)
+		return false;
+
+	time_t mtime; WDL_INT64 size;
+	if (!GetFileStamp(_fn, &mtime, &size))
+		return LoadChunk(_fn, _chunkOut); // let LoadChunk() fail (or succeed) as usual
+
+	{
+		SWS_SectionLock lock(&g_chunkCacheMutex);
+		int idx = FindCachedChunk(_fn);
+		if (SNM_CachedChunk* c = g_chunkCache.Get(idx))
+		{
+			if (c->mtime == mtime && c->size == size)
+			{
+				c->lastUse = ++g_chunkCacheClock;
+				_chunkOut->Set(&c->chunk);
+				return true;
+			}
+			g_chunkCache.Delete(idx, true);
+		}
+	}
+
+	if (!LoadChunk(_fn, _chunkOut))
+		return false;
+
+	SWS_SectionLock lock(&g_chunkCacheMutex);
+	AddCachedChunk(_fn, _chunkOut, mtime, size);
+	return true;
+}
+
+void InvalidateCachedChunk(const char* _fn)
+{
+	if (_fn && *_fn)
+	{
+		SWS_SectionLock lock(&g_chunkCacheMutex);
+		int idx = FindCachedChunk(_fn);
+		if (idx>=0) g_chunkCache.Delete(idx, true);
+	}
+}
+
+static unsigned int WINAPI ChunkPreloadThread(void*)
+{
+	for (;;)
+	{
+		WDL_FastString fn;
+		{
+			SWS_SectionLock lock(&g_chunkCacheMutex);
+			if (g_chunkPreloadExit || !g_chunkPreloadQueue.GetSize())
+			{
+				g_chunkPreloadQueue.Empty(true);
+				g_chunkPreloading = false;
+				return 0;
+			}
+			fn.Set(g_chunkPreloadQueue.Get(0));
+			g_chunkPreloadQueue.Delete(0, true);
+		}
+
+		time_t mtime; WDL_INT64 size;
+		if (!GetFileStamp(fn.Get(), &mtime, &size))
+			continue;
+		{
+			SWS_SectionLock lock(&g_chunkCacheMutex);
+			SNM_CachedChunk* c = g_chunkCache.Get(FindCachedChunk(fn.Get()));
+			if (c && c->mtime == mtime && c->size == size)
+				continue;
+		}
+
+		// file i/o out of the lock
+		WDL_FastString chunk;
+		if (LoadChunk(fn.Get(), &chunk))
+		{
+			SWS_SectionLock lock(&g_chunkCacheMutex);
+			AddCachedChunk(fn.Get(), &chunk, mtime, size);
+		}
+	}
+}
+
+// queue a file for preloading by the worker thread (no-op if already queued)
+void PreloadChunk(const char* _fn)
+{
+	if (!_fn || !*_fn)
+		return;
+
+	SWS_SectionLock lock(&g_chunkCacheMutex);
+	if (g_chunkPreloadExit)
+		return;
+	for (int i=0; i<g_chunkPreloadQueue.GetSize(); i++)
+		if (!strcmp(g_chunkPreloadQueue.Get(i)->Get(), _fn))
+			return;
+	if (g_chunkPreloadQueue.GetSize() >= SNM_CHUNK_PRELOAD_MAX)
+		g_chunkPreloadQueue.Delete(0, true); // most recent requests first
+	g_chunkPreloadQueue.Add(new WDL_FastString(_fn));
+
+	if (!g_chunkPreloading)
+	{
+		g_chunkPreloading = true;
+		if (HANDLE hThread = (HANDLE)_beginthreadex(NULL, 0, ChunkPreloadThread, NULL, 0, NULL))
+			CloseHandle(hThread);
+		else
+			g_chunkPreloading = false;
+	}
+}
+
+// stops preloading and waits for the worker thread (at exit)
+void ChunkCacheExit()
+{
+	{
+		SWS_SectionLock lock(&g_chunkCacheMutex);
+		g_chunkPreloadExit = true;
+	}
+	for (int i=0; i<500; i++) // a pending file read cannot be interrupted, 5s max
+	{
+		{
+			SWS_SectionLock lock(&g_chunkCacheMutex);
+			if (!g_chunkPreloading)
+				break;
+		}
+		Sleep(10);
+	}
+	SWS_SectionLock lock(&g_chunkCacheMutex);
+	g_chunkCache.Empty(true);
+}
+
 // note: WDL's ProjectCreateFileWrite() seems very slow..
 bool SaveChunk(const char* _fn, WDL_FastString* _chunk, bool _indent)
 {
 	if (_fn && *_fn && _chunk)
 	{
+		InvalidateCachedChunk(_fn);
 		SNM_ChunkIndenter p(_chunk, false); // no auto-commit, see trick below
 		if (_indent) p.Indent();
 		if (FILE* f = fopenUTF8(_fn, "w"))
@@ -825,6 +1033,55 @@ double SeekPlay(double _pos, bool _moveView)
 // Action helpers
 ///////////////////////////////////////////////////////////////////////////////
 
+// cmd id -> index in section->action_list, rebuilt when the action list is reallocated/resized
+// (hits are O(log n), a miss costs the former linear walk)
+struct SectionCmdIndex
+{
+	KbdSectionInfo* section;
+	KbdCmd* list;
+	int cnt;
+	WDL_IntKeyedArray<int> idx;
+};
+static WDL_PtrList_DOD<SectionCmdIndex> s_sectionCmdIndexes;
+
+static bool IsCmdInSection(KbdSectionInfo* _section, int _cmdId)
+{
+	SectionCmdIndex* sci = NULL;
+	for (int i=0; !sci && i<s_sectionCmdIndexes.GetSize(); i++)
+		if (s_sectionCmdIndexes.Get(i)->section == _section)
+			sci = s_sectionCmdIndexes.Get(i);
+	if (!sci)
+	{
+		sci = s_sectionCmdIndexes.Add(new SectionCmdIndex);
+		sci->section = _section;
+		sci->list = NULL;
+		sci->cnt = -1;
+	}
+
+	if (sci->list != _section->action_list || sci->cnt != _section->action_list_cnt)
+	{
+		sci->list = _section->action_list;
+		sci->cnt = _section->action_list_cnt;
+		sci->idx.DeleteAll();
+		for (int i=0; i<sci->cnt; i++)
+			sci->idx.AddUnsorted(sci->list[i].cmd, i);
+		sci->idx.Resort();
+	}
+
+	int i = sci->idx.Get(_cmdId, -1);
+	if (i>=0 && i<_section->action_list_cnt && _section->action_list[i].cmd == _cmdId)
+		return true;
+
+	// miss: the list may have been modified in place, check it the former way
+	for (i=0; i<_section->action_list_cnt; i++)
+		if (_section->action_list[i].cmd == _cmdId)
+		{
+			sci->cnt = -1; // stale index, rebuilt on next call
+			return true;
+		}
+	return false;
+}
+
 // "fixes" the API's NamedCommandLookup, e.g. NamedCommandLookup("65534")
 // returns "65534" although this action doesn't exist
 // _hardCheck: if true, do more tests on the returned command id because the 
@@ -839,24 +1096,22 @@ int SNM_NamedCommandLookup(const char* _custId, KbdSectionInfo* _section, bool _
 	int cmdId = 0;
 	if (_custId && *_custId)
 	{
-		// NamedCommandLookup() works for all sections (unique command ids accross sections)
-		if (*_custId == '_')
-			cmdId = NamedCommandLookup(_custId);
-		else
-			cmdId = atoi(_custId);
+		KbdSectionInfo* section = _section ? _section : SNM_GetActionSection(SNM_SEC_IDX_MAIN);
 
-		// make sure things like -666 won't match
-		if (cmdId)
+		// SWS main section actions are known without asking REAPER nor checking the action list
+		if (*_custId == '_' && section == SNM_GetActionSection(SNM_SEC_IDX_MAIN))
+			cmdId = SWSGetCommandIDByName(_custId);
+
+		if (!cmdId)
 		{
-			bool found = false;
-			KbdSectionInfo* section = _section ? _section : SNM_GetActionSection(SNM_SEC_IDX_MAIN);
-			for (int i=0; i<section->action_list_cnt; i++) {
-				if (section->action_list[i].cmd == cmdId) {
-					found = true;
-					break;
-				}
-			}
-			if (!found)
+			// NamedCommandLookup() works for all sections (unique command ids accross sections)
+			if (*_custId == '_')
+				cmdId = NamedCommandLookup(_custId);
+			else
+				cmdId = atoi(_custId);
+
+			// make sure things like -666 won't match
+			if (cmdId && !IsCmdInSection(section, cmdId))
 				cmdId = 0;
 		}
 	}
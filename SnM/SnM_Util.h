@@ -47,7 +47,12 @@ void RevealFile(const char* _fn, bool _errMsg = true);
 bool BrowseResourcePath(const char* _title, const char* _dir, const char* _fileFilters, char* _fn, int _fnSize, bool _wantFullPath = false);
 const char* GetShortResourcePath(const char* _resSubDir, const char* _fullFn);
 void GetFullResourcePath(const char* _resSubDir, const char* _shortFn, char* _fullFn, int _fullFnSize);
+bool GetFileStamp(const char* _fn, time_t* _mtime, WDL_INT64* _size);
 bool LoadChunk(const char* _fn, WDL_FastString* _chunkOut, bool _trim = true, int _approxMaxlen = 0);
+bool LoadChunkCached(const char* _fn, WDL_FastString* _chunkOut);
+void InvalidateCachedChunk(const char* _fn);
+void PreloadChunk(const char* _fn);
+void ChunkCacheExit();
 bool SaveChunk(const char* _fn, WDL_FastString* _chunk, bool _indent);
 WDL_HeapBuf* LoadBin(const char* _fn);
 bool SaveBin(const char* _fn, const WDL_HeapBuf* _hb);
@@ -29,6 +29,43 @@
 #include "stdafx.h"
 #include "TracklistFilter.h"
 
+// Lowercase track names keyed by track GUID, so that filtering does not copy/lowercase
+// every track name on every keystroke. Entries are dropped on rename and the whole
+// index on track list changes, missing ones are (re)built on demand.
+// g_iNameIndexGen changes whenever a name may have changed.
+static std::map<GUID, std::string, GUIDLess> g_nameIndex;
+static int g_iNameIndexGen = 0;
+
+static const char* GetLowercaseTrackName(MediaTrack* tr)
+{
+	GUID* g = GetTrackGUID(tr);
+	if (!g)
+		return "";
+	std::map<GUID, std::string, GUIDLess>::iterator it = g_nameIndex.find(*g);
+	if (it == g_nameIndex.end())
+	{
+		const char* name = (const char*)GetSetMediaTrackInfo(tr, "P_NAME", NULL);
+		std::string lcName(name ? name : "");
+		for (size_t i = 0; i < lcName.size(); i++)
+			lcName[i] = tolower(lcName[i]);
+		it = g_nameIndex.insert(std::make_pair(*g, lcName)).first;
+	}
+	return it->second.c_str();
+}
+
+void TracklistFilterSetTrackTitle(MediaTrack* tr)
+{
+	if (GUID* g = GetTrackGUID(tr))
+		if (g_nameIndex.erase(*g))
+			g_iNameIndexGen++;
+}
+
+void TracklistFilterSetTrackListChange()
+{
+	g_nameIndex.clear();
+	g_iNameIndexGen++;
+}
+
 // TODO UTF8 support here
 void FilteredVisState::SetFilter(const char* cFilter)
 {
@@ -36,11 +73,10 @@ void FilteredVisState::SetFilter(const char* cFilter)
 		m_sFilter.Set(cFilter);
 	else
 		m_sFilter.Set("");
-	static WDL_String sLCFilter;
-	sLCFilter.Set(m_sFilter.Get());
-	for (int i = 0; i < sLCFilter.GetLength(); i++)
-		sLCFilter.Get()[i] = tolower(sLCFilter.Get()[i]);
-	m_parsedFilter->parse(sLCFilter.Get());
+	m_sLCFilter.Set(m_sFilter.Get());
+	for (int i = 0; i < m_sLCFilter.GetLength(); i++)
+		m_sLCFilter.Get()[i] = tolower(m_sLCFilter.Get()[i]);
+	m_parsedFilter->parse(m_sLCFilter.Get());
 }
 
 void FilteredVisState::Init(LineParser* lp)
@@ -84,28 +120,53 @@ char* FilteredVisState::ItemString(char* str, int maxLen, bool* bDone)
 	return str;
 }
 
+// True if every token of the current filter extends the matching token of the last
+// GetFilteredTracks() filter, i.e. the matches can only be a subset of the last ones
+bool FilteredVisState::IsFilterRefined()
+{
+	if (m_iMatchedGen != g_iNameIndexGen || !m_matchedFilter->getnumtokens() ||
+		m_matchedFilter->getnumtokens() != m_parsedFilter->getnumtokens())
+		return false;
+	for (int j = 0; j < m_parsedFilter->getnumtokens(); j++)
+		if (!strstr(m_parsedFilter->gettoken_str(j), m_matchedFilter->gettoken_str(j)))
+			return false;
+	return true;
+}
+
 WDL_PtrList<void>* FilteredVisState::GetFilteredTracks()
 {
-	static WDL_PtrList<void> tracks;
-	tracks.Empty();
-	
-	for (int i = 1; i <= GetNumTracks(); i++)
+	if (IsFilterRefined())
 	{
-		MediaTrack* tr = CSurf_TrackFromID(i, false);
-		if (MatchesFilter(tr))
-			tracks.Add(tr);
+		for (int i = m_matched.GetSize() - 1; i >= 0; i--)
+			if (!MatchesFilter((MediaTrack*)m_matched.Get(i)))
+				m_matched.Delete(i);
 	}
-	return &tracks;
+	else
+	{
+		m_matched.Empty();
+		for (int i = 1; i <= GetNumTracks(); i++)
+		{
+			MediaTrack* tr = CSurf_TrackFromID(i, false);
+			if (MatchesFilter(tr))
+				m_matched.Add(tr);
+		}
+	}
+
+	m_iMatchedGen = g_iNameIndexGen;
+	m_matchedFilter->parse(m_parsedFilter->getnumtokens() ? m_sLCFilter.Get() : "");
+	return &m_matched;
 }
 
 bool FilteredVisState::UpdateReaper(bool bHideFiltered)
 {
 	bool bChanged = false;
 
-	// Remove tracks from filteredOut that aren't in the project
+	// Hash the filteredOut list, the list is rebuilt in track order below
+	WDL_PtrKeyedArray<TrackVisState*> filteredOut;
 	for (int i = 0; i < m_filteredOut.GetSize(); i++)
-		if (CSurf_TrackToID(m_filteredOut.Get(i)->tr, false) <= 0)
-			m_filteredOut.Delete(i--, true);
+		filteredOut.AddUnsorted((INT_PTR)m_filteredOut.Get(i)->tr, m_filteredOut.Get(i));
+	filteredOut.Resort();
+	m_filteredOut.Empty(false);
 
 	for (int i = 1; i <= GetNumTracks(); i++)
 	{
@@ -115,20 +176,19 @@ bool FilteredVisState::UpdateReaper(bool bHideFiltered)
 		bool bShow = !bHideFiltered || MatchesFilter(tr);
 
 		// Is this track in the filteredOut list?
-		int j;
-		for (j = 0; j < m_filteredOut.GetSize(); j++)
-			if (m_filteredOut.Get(j)->tr == tr)
-				break;
-		
-		if (j < m_filteredOut.GetSize())
+		if (TrackVisState* tvs = filteredOut.Get((INT_PTR)tr, NULL))
 		{
+			filteredOut.Insert((INT_PTR)tr, NULL); // handled
 			if (bShow)
 			{
-				iNewVis = m_filteredOut.Get(j)->iVis;
-				m_filteredOut.Delete(j, true);
+				iNewVis = tvs->iVis;
+				delete tvs;
 			}
 			else
+			{
 				iNewVis = 0;
+				m_filteredOut.Add(tvs);
+			}
 		}
 		else if (!bShow)
 		{
@@ -145,6 +205,10 @@ bool FilteredVisState::UpdateReaper(bool bHideFiltered)
 		}
 	}
 
+	// Remove tracks from filteredOut that aren't in the project
+	for (int i = 0; i < filteredOut.GetSize(); i++)
+		delete filteredOut.Enumerate(i);
+
 	if (bChanged)
 	{
 		TrackList_AdjustWindows(false);
@@ -156,16 +220,13 @@ bool FilteredVisState::UpdateReaper(bool bHideFiltered)
 
 bool FilteredVisState::MatchesFilter(MediaTrack* tr)
 {
-	static WDL_String sTrackName;
 	if (!m_parsedFilter->getnumtokens())
 		return true;
-	sTrackName.Set((char*)GetSetMediaTrackInfo(tr, "P_NAME", NULL));
-	if (!sTrackName.GetLength())
+	const char* cTrackName = GetLowercaseTrackName(tr);
+	if (!*cTrackName)
 		return false;
-	for (int i = 0; i < sTrackName.GetLength(); i++)
-		sTrackName.Get()[i] = tolower(sTrackName.Get()[i]);
 	for (int j = 0; j < m_parsedFilter->getnumtokens(); j++)
-		if (strstr(sTrackName.Get(), m_parsedFilter->gettoken_str(j)))
+		if (strstr(cTrackName, m_parsedFilter->gettoken_str(j)))
 			return true;
 	return false;
 }
@@ -37,8 +37,8 @@ typedef struct TrackVisState
 class FilteredVisState
 {
 public:
-	FilteredVisState() { m_parsedFilter = new LineParser(false); }
-	~FilteredVisState() { m_filteredOut.Empty(true); delete m_parsedFilter; }
+	FilteredVisState():m_iMatchedGen(-1) { m_parsedFilter = new LineParser(false); m_matchedFilter = new LineParser(false); }
+	~FilteredVisState() { m_filteredOut.Empty(true); delete m_parsedFilter; delete m_matchedFilter; }
 	void SetFilter(const char* cFilter);
 	const char* GetFilter() { return m_sFilter.Get(); }
 	void Init(LineParser* lp);
@@ -48,7 +48,18 @@ public:
 
 private:
 	bool MatchesFilter(MediaTrack* tr);
+	bool IsFilterRefined();
 	WDL_String m_sFilter;
+	WDL_String m_sLCFilter;
 	LineParser* m_parsedFilter;
 	WDL_PtrList<TrackVisState> m_filteredOut;
+
+	// Result of the last GetFilteredTracks(), refined when the filter is only extended
+	WDL_PtrList<void> m_matched;
+	LineParser* m_matchedFilter;
+	int m_iMatchedGen;
 };
+
+// Keep the lowercase track name index in sync
+void TracklistFilterSetTrackTitle(MediaTrack* tr);
+void TracklistFilterSetTrackListChange();
@@ -28,13 +28,52 @@
 #include "../reaper/localize.h"
 #include "envelope.hpp"
 
+static const size_t CHUNK_MAX_SIZE = 100 << 20; // 100 MiB
+
+// size of the envelope's chunk the last time we've got it, so we can start with
+// a buffer that is big enough instead of doubling our way up to it
+static std::map<TrackEnvelope *, size_t> s_chunkSizes;
+
+static size_t EstimateChunkSize(TrackEnvelope *envelope)
+{
+	// "PT 123.456789012345 0.5000000000 0 0 1 0 0.00000000" + header and automation items
+	size_t size = 1024 + CountEnvelopePoints(envelope) * 64;
+
+	const std::map<TrackEnvelope *, size_t>::const_iterator it = s_chunkSizes.find(envelope);
+	if (it != s_chunkSizes.end())
+		size = std::max(size, it->second + it->second / 8);
+
+	return std::min(size, CHUNK_MAX_SIZE);
+}
+
+static void RememberChunkSize(TrackEnvelope *envelope, size_t size)
+{
+	// pointers of deleted envelopes are never removed, don't let it grow forever
+	if (s_chunkSizes.size() > 4096)
+		s_chunkSizes.clear();
+
+	s_chunkSizes[envelope] = size;
+}
+
 // wraps GetEnvelopeStateChunk() to make it more save
 // until maybe it gets enhanced one day
 // https://forum.cockos.com/showthread.php?p=2142245#post2142245
 // throws envelope::bad_get_env_chunk_big on failure
-std::string envelope::GetEnvelopeStateChunkBig(TrackEnvelope *envelope, bool isUndo /*= false*/)
+std::string &envelope::GetEnvelopeStateChunkBuffer(TrackEnvelope *envelope, bool isUndo /*= false*/)
 {
-	std::string buffer(1024, '\0');
+	static std::string buffer;
+
+	try {
+		const size_t estimate = EstimateChunkSize(envelope);
+		if (buffer.size() < estimate)
+			buffer.resize(estimate);
+	}
+	catch (const std::bad_alloc &) {
+		throw bad_get_env_chunk_big(__LOCALIZE("std::bad_alloc thrown.", "sws_mbox"));
+	}
+
+	// keep the allocation around, only the size is reset after the chunk is read
+	buffer.resize(buffer.capacity());
 
 	while (true) {
 		// can't use std::string::front (C++11) as we're targeting OSX 10.5 (as of September 2019)
@@ -48,10 +87,11 @@ std::string envelope::GetEnvelopeStateChunkBig(TrackEnvelope *envelope, bool isU
 
 		if (endpos != std::string::npos) {
 			buffer.resize(endpos);
+			RememberChunkSize(envelope, endpos);
 			return buffer;
 		}
 
-		if (buffer.size() > 100 << 20) { // 100 MiB
+		if (buffer.size() > CHUNK_MAX_SIZE) {
 			throw bad_get_env_chunk_big(__LOCALIZE("The envelope chunk size exceeded the 100 MiB limit.", "sws_mbox"));
 		}
 
@@ -63,5 +103,49 @@ std::string envelope::GetEnvelopeStateChunkBig(TrackEnvelope *envelope, bool isU
 		}
 	}
 
-	return {};
+	buffer.clear();
+	return buffer;
+}
+
+std::string envelope::GetEnvelopeStateChunkBig(TrackEnvelope *envelope, bool isUndo /*= false*/)
+{
+	return GetEnvelopeStateChunkBuffer(envelope, isUndo);
+}
+
+envelope::LineIterator::LineIterator(char *chunk, size_t size)
+	: m_pos(chunk), m_end(chunk ? chunk + size : chunk)
+{
+}
+
+envelope::LineIterator::LineIterator(char *chunk)
+	: m_pos(chunk), m_end(chunk ? chunk + strlen(chunk) : chunk)
+{
+}
+
+envelope::LineIterator::LineIterator(std::string &chunk)
+	: m_pos(&chunk[0]), m_end(&chunk[0] + chunk.size())
+{
+}
+
+char *envelope::LineIterator::next()
+{
+	if (m_pos >= m_end)
+		return nullptr;
+
+	char *line = m_pos;
+	char *eol = static_cast<char *>(memchr(m_pos, '\n', m_end - m_pos));
+
+	if (eol) {
+		*eol = '\0';
+		m_pos = eol + 1;
+	}
+	else
+		m_pos = m_end; // last line is already terminated by the chunk's terminator
+
+	return line;
+}
+
+char *envelope::LineIterator::rest()
+{
+	return m_pos < m_end ? m_pos : nullptr;
 }
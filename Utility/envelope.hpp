@@ -32,6 +32,26 @@ namespace envelope
 {
 std::string GetEnvelopeStateChunkBig(TrackEnvelope *, bool isUndo = false);
 
+// same as GetEnvelopeStateChunkBig() but returns a buffer that is reused
+// (and overwritten) by the next call, saves reallocating it for every envelope
+// main thread only, like the rest of the chunk API
+std::string &GetEnvelopeStateChunkBuffer(TrackEnvelope *, bool isUndo = false);
+
+// iterates over the lines of a chunk, each line is null-terminated in place
+// (unlike strtok, it can be nested and doesn't skip empty lines)
+class LineIterator {
+public:
+	LineIterator(char *chunk, size_t size); // chunk[size] must be '\0'
+	explicit LineIterator(char *chunk); // null-terminated chunk
+	explicit LineIterator(std::string &chunk);
+
+	char *next(); // NULL at the end of the chunk
+	char *rest(); // remaining lines as-is (NULL if none)
+
+private:
+	char *m_pos, *m_end;
+};
+
 class bad_get_env_chunk_big : public std::runtime_error {
 public:
 	using runtime_error::runtime_error;
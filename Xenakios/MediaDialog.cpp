@@ -51,6 +51,57 @@ struct t_project_take
 
 vector<t_mediafile_status> g_RProjectFiles;
 
+// File existence checks fanned out to worker threads (media on network shares/archives
+// can take several ms per stat). exists[i] is set for files[i]
+#define MEDIA_STAT_THREADS 8
+#define MEDIA_STAT_MIN_PER_THREAD 64
+
+struct t_stat_job
+{
+	const vector<string>* files;
+	vector<char>* exists;
+	int first, step;
+};
+
+unsigned int WINAPI StatFilesThreadFunc(void* p)
+{
+	t_stat_job* job=(t_stat_job*)p;
+	for (int i=job->first;i<(int)job->files->size();i+=job->step)
+		(*job->exists)[i]=FileExists((*job->files)[i].c_str()) ? 1 : 0;
+	return 0;
+}
+
+void StatFiles(const vector<string>& files, vector<char>& exists)
+{
+	exists.assign(files.size(),0);
+	int nThreads=min(MEDIA_STAT_THREADS,(int)files.size()/MEDIA_STAT_MIN_PER_THREAD);
+	if (nThreads<2)
+	{
+		for (int i=0;i<(int)files.size();i++)
+			exists[i]=FileExists(files[i].c_str()) ? 1 : 0;
+		return;
+	}
+
+	t_stat_job jobs[MEDIA_STAT_THREADS];
+	HANDLE threads[MEDIA_STAT_THREADS];
+	for (int t=0;t<nThreads;t++)
+	{
+		jobs[t].files=&files;
+		jobs[t].exists=&exists;
+		jobs[t].first=t;
+		jobs[t].step=nThreads;
+		threads[t]=(HANDLE)_beginthreadex(NULL, 0, StatFilesThreadFunc, &jobs[t], 0, NULL);
+		if (!threads[t]) // do this share on the main thread
+			StatFilesThreadFunc(&jobs[t]);
+	}
+	for (int t=0;t<nThreads;t++)
+		if (threads[t])
+		{
+			WaitForSingleObject(threads[t], INFINITE);
+			CloseHandle(threads[t]);
+		}
+}
+
 string RemoveDoubleBackSlashes(string TheFileName)
 {
 	string ResultString;
@@ -76,6 +127,8 @@ string RemoveDoubleBackSlashes(string TheFileName)
 void GetAllProjectTakes(vector<t_project_take>& ATakeList)
 {
 	ATakeList.clear();
+	map<string,int> fileIdx; // unique file names -> index in files
+	vector<string> files;
 	MediaTrack *CurTrack;
 	MediaItem *CurItem;
 	MediaItem_Take *CurTake;
@@ -116,21 +169,24 @@ void GetAllProjectTakes(vector<t_project_take>& ATakeList)
 				TakeBlah.FileMissing=false;
 				if (!pureMIDItake)
 				{
-					if (!FileExists(TakeBlah.FileName.c_str()))
-						TakeBlah.FileMissing=true;
-
+					if (fileIdx.insert(make_pair(TakeBlah.FileName,(int)files.size())).second)
+						files.push_back(TakeBlah.FileName);
 					ATakeList.push_back(TakeBlah);
 				}
 			}
 		}
 	}
+
+	vector<char> exists;
+	StatFiles(files,exists);
+	for (i=0;i<(int)ATakeList.size();i++)
+		ATakeList[i].FileMissing=!exists[fileIdx[ATakeList[i].FileName]];
 }
 
 void GetProjectFileList(vector<t_mediafile_status>& AMediaList)
 {
-	vector<string> ProjectFiles;
 	vector<string> TempList;
-	vector<int> vecusedcount;
+	set<string> TempSet;
 	int i;
 	int j;
 	int k;
@@ -170,17 +226,8 @@ void GetProjectFileList(vector<t_mediafile_status>& AMediaList)
 								else
 									FName.assign("no file...");
 							}
-							if (!ispurelyMIDI)
-							{
-								int Matches=0;
-								for (int L=0;L<(int)TempList.size();L++)
-								{
-									if (FName.compare(TempList[L])==0)
-										Matches++;
-								}
-								if (Matches==0)
-									TempList.push_back(FName);
-							}
+							if (!ispurelyMIDI && TempSet.insert(FName).second)
+								TempList.push_back(FName);
 						}
 					}
 				}
@@ -188,7 +235,11 @@ void GetProjectFileList(vector<t_mediafile_status>& AMediaList)
 		}
 	}
 
+	vector<char> exists;
+	StatFiles(TempList,exists);
+
 	AMediaList.clear();
+	AMediaList.reserve(TempList.size());
 	for (i=0;i<(int)TempList.size();i++)
 	{
 		t_mediafile_status newstatus;
@@ -196,21 +247,14 @@ void GetProjectFileList(vector<t_mediafile_status>& AMediaList)
 		string::size_type pos;
 		while ((pos = newstatus.FileName.find('/')) != string::npos)
 			newstatus.FileName[pos] = '\\';
-		newstatus.IsOnline = FileExists(TempList[i].c_str());
+		newstatus.IsOnline = exists[i]!=0;
 		AMediaList.push_back(newstatus);
 	}
 }
 
-int IsFileUsedInProject(string AFile)
+int IsFileUsedInProject(const set<string>& projectFiles, const string& AFile)
 {
-	int Matches=0;
-	int i;
-	for (i=0;i<(int)g_RProjectFiles.size();i++)
-	{
-		if (AFile.compare(g_RProjectFiles[i].FileName)==0) Matches++;
-	}
-	return Matches;
-	//if (Matches>0) return true; else return false;
+	return projectFiles.count(AFile) ? 1 : 0; // g_RProjectFiles has no duplicates
 }
 
 vector<string> g_ProjFolFiles;
@@ -249,6 +293,10 @@ void UpdateProjFolderList(HWND hList, bool onlyUnused)
 	bool HidePaths=false;
 	if (IsDlgButtonChecked(g_hMediaDlg,IDC_HIDEPATHS) == BST_CHECKED)
 		HidePaths=true;
+	set<string> projectFiles;
+	for (i=0;i<(int)g_RProjectFiles.size();i++)
+		projectFiles.insert(g_RProjectFiles[i].FileName);
+
 	for (i=0;i<(int)g_ProjFolFiles.size();i++)
 	{
 		string *TempString=new string;
@@ -267,7 +315,7 @@ void UpdateProjFolderList(HWND hList, bool onlyUnused)
 
 		item.iItem=j;
 		item.iSubItem = 0;
-		int UsedInProject=IsFileUsedInProject(g_ProjFolFiles[i]);
+		int UsedInProject=IsFileUsedInProject(projectFiles,g_ProjFolFiles[i]);
 		if (onlyUnused)
 		{
 			if (UsedInProject==0)
@@ -465,85 +513,65 @@ void FindMissingFiles()
 {
 	if (BrowseForDirectory("Select search folder", NULL, g_FolderName, 1024))
 	{
-		char FullFilename[2048];
-		char FullFilenameB[2048];
 		char Shortfilename[2048];
-		char ShortfilenameB[2048];
 
 		DialogBox(g_hInst,MAKEINTRESOURCE(IDD_SCANPROGR),g_hMediaDlg,(DLGPROC)ScanProgDlgProc);
 		g_ScanStatus=0;
 		g_ScanFinished=true;
 		SetForegroundWindow(g_hMediaDlg);
+
+		// Index scanned files by name (without path)
+		map<string, vector<int> > FoundByName;
+		int i;
+		for (i=0;i<(int)FoundMediaFiles.size();i++)
+		{
+			ExtractFileNameEx(FoundMediaFiles[i].c_str(),Shortfilename,false);
+			FoundByName[Shortfilename].push_back(i);
+		}
+
+		// Group takes by missing file, each file is resolved once
 		vector<t_project_take> ProjectTakes;
-		vector<t_project_take> TakesMissingFiles;
 		GetAllProjectTakes(ProjectTakes);
-		int i;
+		vector<string> MissingFiles;
+		map<string, vector<MediaItem_Take*> > TakesMissingFiles;
 		for (i=0;i<(int)ProjectTakes.size();i++)
+		{
 			if (ProjectTakes[i].FileMissing==true)
-				TakesMissingFiles.push_back(ProjectTakes[i]);
+			{
+				vector<MediaItem_Take*>& takes=TakesMissingFiles[ProjectTakes[i].FileName];
+				if (takes.empty())
+					MissingFiles.push_back(ProjectTakes[i].FileName);
+				takes.push_back(ProjectTakes[i].TheTake);
+			}
+		}
 		Main_OnCommand(40100,0); // set all media offline
-		int SanityCheck=(int)TakesMissingFiles.size();
-		i=0;
 
-		bool TakesLeft=true;
-		if (TakesMissingFiles.size()==0) TakesLeft=false;
-		while (TakesLeft==true)
+		for (i=0;i<(int)MissingFiles.size();i++)
 		{
-			t_project_take TempTake;
-			TempTake=TakesMissingFiles[i];
-			int FileMatches=0;
-			strcpy(FullFilename,TakesMissingFiles[i].FileName.c_str());
-			ExtractFileNameEx(FullFilename,Shortfilename,false);
+			ExtractFileNameEx(MissingFiles[i].c_str(),Shortfilename,false);
 			g_MatchingFiles.clear();
-			int j;
-			for (j=0;j<(int)FoundMediaFiles.size();j++)
-			{
-				strcpy(FullFilenameB,FoundMediaFiles[j].c_str());
-				ExtractFileNameEx(FullFilenameB,ShortfilenameB,false);
-				if (strcmp(Shortfilename,ShortfilenameB)==0)
-				{
-					FileMatches++;
-					g_MatchingFiles.push_back(FoundMediaFiles[j]);
-				}
-			}
+			map<string, vector<int> >::iterator it=FoundByName.find(Shortfilename);
+			if (it!=FoundByName.end())
+				for (int j=0;j<(int)it->second.size();j++)
+					g_MatchingFiles.push_back(FoundMediaFiles[it->second[j]]);
+
 			string TheMatchingFile;
-			TheMatchingFile.assign(TakesMissingFiles[i].FileName);
-			if (g_MatchingFiles.size()==0)
-				TakesMissingFiles.erase(TakesMissingFiles.begin()+i);
-			else if (g_MatchingFiles.size()==1)
-			{
+			if (g_MatchingFiles.size()==1)
 				TheMatchingFile.assign(g_MatchingFiles[0]);
-				ReplaceTakeSourceFile(TakesMissingFiles[i].TheTake,TheMatchingFile);
-				TakesMissingFiles.erase(TakesMissingFiles.begin()+i);
-			}
 			else if (g_MatchingFiles.size()>1)
 			{
 				g_SelectedMatchFile=-1;
 				DialogBox(g_hInst,MAKEINTRESOURCE(IDD_MULMATCH),g_hMediaDlg , (DLGPROC)MulMatchesFoundDlgProc);
 				if (g_SelectedMatchFile>=0)
-				{
 					TheMatchingFile.assign(g_MatchingFiles[g_SelectedMatchFile]);
-					ReplaceTakeSourceFile(TakesMissingFiles[i].TheTake,TheMatchingFile);
-				}
-				TakesMissingFiles.erase(TakesMissingFiles.begin()+i);
-			}
-			// Searching remaining takes using the same file...
-			int k;
-			for (k=0;k<(int)TakesMissingFiles.size();k++)
-			{
-				if (TakesMissingFiles[k].FileName.compare(FullFilename)==0)
-				{
-					// replace file
-					ReplaceTakeSourceFile(TakesMissingFiles[k].TheTake,TheMatchingFile);
-					TakesMissingFiles.erase(TakesMissingFiles.begin()+k);
-				}
 			}
-			if (TakesMissingFiles.size()==0) TakesLeft=false;
-			SanityCheck--;
-			if (SanityCheck<0)
+
+			// replace file for all takes using it
+			if (TheMatchingFile.size())
 			{
-				// Sanity check, exiting while (TakesMissingFiles.size()>0)
-				break;
+				vector<MediaItem_Take*>& takes=TakesMissingFiles[MissingFiles[i]];
+				for (int k=0;k<(int)takes.size();k++)
+					ReplaceTakeSourceFile(takes[k],TheMatchingFile);
 			}
 		}
 		Main_OnCommand(40101,0); // set all media online
@@ -552,10 +580,10 @@ void FindMissingFiles()
 	}
 }
 
-int NumTimesFileUsedInProject(string &fn, vector<MediaItem_Take*>& thetakes)
+// file name -> number of takes using it, built once for all files
+void CountFilesUsedInProject(map<string,int>& counts, vector<MediaItem_Take*>& thetakes)
 {
 	int i;
-	int matches=0;
 	string cmpfn;
 	for (i=0;i<(int)thetakes.size();i++)
 	{
@@ -571,11 +599,9 @@ int NumTimesFileUsedInProject(string &fn, vector<MediaItem_Take*>& thetakes)
 				if (src2)
 					cmpfn.assign(src2->GetFileName() ? src2->GetFileName() : "");
 			}
-			if (fn.compare(cmpfn)==0)
-				matches++;
+			counts[cmpfn]++;
 		}
 	}
-	return matches;
 }
 
 void PopulateProjectUsedList(bool HidePaths)
@@ -585,6 +611,8 @@ void PopulateProjectUsedList(bool HidePaths)
 	char buf[2048];
 	vector<MediaItem_Take*> thetakes;
 	XenGetProjectTakes(thetakes, false, false);
+	map<string,int> usedCounts;
+	CountFilesUsedInProject(usedCounts, thetakes);
 
 	for (int i = 0; i < (int)g_RProjectFiles.size(); i++)
 	{
@@ -603,7 +631,8 @@ void PopulateProjectUsedList(bool HidePaths)
 		ListView_InsertItem(GetDlgItem(g_hMediaDlg, IDC_PROJFILES_USED), &item);
 		ListView_SetItemText(GetDlgItem(g_hMediaDlg,IDC_PROJFILES_USED), i, 2, g_RProjectFiles[i].IsOnline ? "Online" : "Missing");
 		char ynh[20];
-		sprintf(ynh, "%d", NumTimesFileUsedInProject(g_RProjectFiles[i].FileName, thetakes));
+		map<string,int>::iterator it = usedCounts.find(g_RProjectFiles[i].FileName);
+		sprintf(ynh, "%d", it != usedCounts.end() ? it->second : 0);
 		ListView_SetItemText(GetDlgItem(g_hMediaDlg, IDC_PROJFILES_USED), i, 1, ynh);
 	}
 }
@@ -244,26 +244,24 @@ vector<t_trackheight_struct> g_vec_trackheighs;
 
 void DoSelTraxHeightA(COMMAND_T*)
 {
+	SWS_TrackTransaction trans;
 	for (int i=0;i<GetNumTracks();i++)
 	{
 		MediaTrack* CurTrack=CSurf_TrackFromID(i+1,false);
 		if (*(int*)GetSetMediaTrackInfo(CurTrack,"I_SELECTED",NULL))
-			GetSetMediaTrackInfo(CurTrack,"I_HEIGHTOVERRIDE",&g_command_params.TrackHeightA);
+			trans.Set(CurTrack,"I_HEIGHTOVERRIDE",g_command_params.TrackHeightA);
 	}
-	TrackList_AdjustWindows(false);
-	UpdateTimeline();
 }
 
 void DoSelTraxHeightB(COMMAND_T*)
 {
+	SWS_TrackTransaction trans;
 	for (int i=0;i<GetNumTracks();i++)
 	{
 		MediaTrack* CurTrack=CSurf_TrackFromID(i+1,false);
 		if (*(int*)GetSetMediaTrackInfo(CurTrack,"I_SELECTED",NULL))
-			GetSetMediaTrackInfo(CurTrack,"I_HEIGHTOVERRIDE",&g_command_params.TrackHeightB);
+			trans.Set(CurTrack,"I_HEIGHTOVERRIDE",g_command_params.TrackHeightB);
 	}
-	TrackList_AdjustWindows(false);
-	UpdateTimeline();
 }
 
 void DoStoreSelTraxHeights(COMMAND_T*)
@@ -285,19 +283,21 @@ void DoStoreSelTraxHeights(COMMAND_T*)
 
 void DoRecallSelectedTrackHeights(COMMAND_T*)
 {
+	map<GUID, int, GUIDLess> heights;
+	for (int j=0;j<(int)g_vec_trackheighs.size();j++)
+		heights[g_vec_trackheighs[j].guid]=g_vec_trackheighs[j].Heigth;
+
+	SWS_TrackTransaction trans;
 	for (int i=0;i<GetNumTracks();i++)
 	{
 		MediaTrack* CurTrack = CSurf_TrackFromID(i+1,false);
 		if (*(int*)GetSetMediaTrackInfo(CurTrack,"I_SELECTED",NULL))
 		{
-			GUID curGUID=*(GUID*)GetSetMediaTrackInfo(CurTrack,"GUID",NULL);
-			for (int j=0;j<(int)g_vec_trackheighs.size();j++)
-				if (GuidsEqual(&curGUID, &g_vec_trackheighs[j].guid))
-					GetSetMediaTrackInfo(CurTrack,"I_HEIGHTOVERRIDE",&g_vec_trackheighs[j].Heigth);	
+			map<GUID, int, GUIDLess>::iterator it=heights.find(*(GUID*)GetSetMediaTrackInfo(CurTrack,"GUID",NULL));
+			if (it!=heights.end())
+				trans.Set(CurTrack,"I_HEIGHTOVERRIDE",it->second);
 		}
 	}
-	TrackList_AdjustWindows(false);
-	UpdateTimeline();
 }
 
 void DoSelectTracksWithNoItems(COMMAND_T*)
@@ -702,13 +702,9 @@ void DoToggleTrackHeightAB(COMMAND_T*)
 			g_CurTrackHeightIdx=0;
 			newHei=g_command_params.TrackHeightA;
 		}
+	SWS_TrackTransaction trans;
 	for (i=0;i<(int)TheTracks.size();i++)
-	{
-		
-		GetSetMediaTrackInfo(TheTracks[i],"I_HEIGHTOVERRIDE",&newHei);
-	}
-	TrackList_AdjustWindows(false);
-	UpdateTimeline();
+		trans.Set(TheTracks[i],"I_HEIGHTOVERRIDE",newHei);
 }
 
 void DoPanTracksCenter(COMMAND_T* ct)
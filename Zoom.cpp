@@ -111,6 +111,35 @@ void SetVertPos(HWND hwnd, int iTrack, bool bPixels, int iExtra = 0) // 1 based
 	SendMessage(hwnd, WM_VSCROLL, si.nPos << 16 | SB_THUMBPOSITION, 0);
 }
 
+// Height model of the tracks in a VertZoomRange() call, gathered once
+struct VZoomTrack
+{
+	MediaTrack* tr;
+	bool bVis;     // shown in TCP
+	int iGap;      // master gap
+	vector<int> envHeights; // custom envelope lane heights, 0 == follows the track height (non-minimize mode)
+};
+
+// Height of all tracks + their envelope lanes for a given vertical zoom level
+static int GetVZoomRangeHeight(vector<VZoomTrack>& tracks, int iZoom)
+{
+	int iHeight = 0;
+	for (size_t i = 0; i < tracks.size(); i++)
+	{
+		if (!tracks[i].bVis)
+			continue;
+		int trackHeight = GetTrackHeightFromVZoomIndex(tracks[i].tr, iZoom);
+		int envHeight = 0;
+		for (size_t j = 0; j < tracks[i].envHeights.size(); j++)
+		{
+			int h = tracks[i].envHeights[j];
+			envHeight += (h != 0) ? h : GetEnvHeightFromTrackHeight(trackHeight);
+		}
+		iHeight += trackHeight + envHeight + tracks[i].iGap;
+	}
+	return iHeight;
+}
+
 void VertZoomRange(int iFirst, int iNum, bool* bZoomed, bool bMinimizeOthers, bool includeEnvelopes)
 {
 	HWND hTrackView = GetTrackWnd();
@@ -124,148 +153,142 @@ void VertZoomRange(int iFirst, int iNum, bool* bZoomed, bool bMinimizeOthers, bo
 	int iTotalHeight = rect.bottom;
 	int lastTrackId = iFirst + iNum - (includeEnvelopes ? 1 : 2);
 
-	if (bMinimizeOthers)
+	// Cache the per-track inputs once, the solvers below only do arithmetic on them
+	vector<VZoomTrack> tracks(iNum);
+	for (int i = 0; i < iNum; i++)
 	{
-		*ConfigVar<int>("vzoom2") = 0;
-		for (int i = 0; i <= GetNumTracks(); i++)
-			GetSetMediaTrackInfo(CSurf_TrackFromID(i, false), "I_HEIGHTOVERRIDE", &g_i0);
-		Main_OnCommand(40112, 0); // Zoom out vert to minimize envelope lanes too (since vZoom is now 0) (calls refresh)
-		//TrackList_AdjustWindows(false);
-		//UpdateTimeline();
-
-		// Get the size of shown but not zoomed tracks
-		int iNotZoomedSize = 0;
-		int iZoomed = 0;
+		VZoomTrack& t = tracks[i];
+		t.tr = CSurf_TrackFromID(i+iFirst, false);
+		t.bVis = TcpVis(t.tr);
+		t.iGap = (t.tr == masterTrack && t.bVis && iNum > 1) ? GetMasterTcpGap() : 0;
+	}
 
-		for (int i = 0; i < iNum; i++)
+	{
+		SWS_TrackTransaction trans;
+		if (bMinimizeOthers)
 		{
-			MediaTrack* tr = CSurf_TrackFromID(i+iFirst, false);
-			if (bZoomed[i])
+			// Minimize everything in the same pass as zoomed track heights are set (no intermediate refresh)
+			*ConfigVar<int>("vzoom2") = 0;
+			for (int i = 0; i <= GetNumTracks(); i++)
 			{
-				iZoomed++;
-				if (tr == masterTrack && TcpVis(tr) && iNum > 1) iNotZoomedSize += GetMasterTcpGap();
+				MediaTrack* tr = CSurf_TrackFromID(i, false);
+				trans.Set(tr, "I_HEIGHTOVERRIDE", 0.0);
+
+				// Minimize envelope lanes too (was done by action 40112): custom lane heights follow the track height again
+				for (int j = 0; j < CountTrackEnvelopes(tr); j++)
+				{
+					BR_Envelope envelope(GetTrackEnvelope(tr, j));
+					if (envelope.IsInLane() && envelope.GetLaneHeight() != 0)
+					{
+						envelope.SetLaneHeight(0);
+						envelope.Commit();
+					}
+				}
 			}
-			else
+
+			// Get the size of shown but not zoomed tracks, and envelope lanes of the zoomed ones
+			int iNotZoomedSize = 0;
+			int iZoomed = 0;
+			int iLanes = 0;
+			for (int i = 0; i < iNum; i++)
 			{
-				if (TcpVis(tr))
+				VZoomTrack& t = tracks[i];
+				if (bZoomed[i])
+				{
+					iZoomed++;
+					iNotZoomedSize += t.iGap;
+					if (i + iFirst <= lastTrackId) // don't check envelope lanes height for the last track if includeEnvelopes == true
+						iLanes += CountTrackEnvelopePanels(t.tr);
+				}
+				else if (t.bVis)
 				{
-					int trackHeight = GetTrackHeightFromVZoomIndex(tr, 0);
-					trackHeight += CountTrackEnvelopePanels(tr) * GetEnvHeightFromTrackHeight(trackHeight);
+					int trackHeight = GetTrackHeightFromVZoomIndex(t.tr, 0);
+					trackHeight += CountTrackEnvelopePanels(t.tr) * GetEnvHeightFromTrackHeight(trackHeight);
 					iNotZoomedSize += trackHeight;
 				}
 			}
-		}
-		// Pixels we have to work with will all the sel tracks and their envelopes
-		iTotalHeight -= iNotZoomedSize;
-		int iEachHeight = iTotalHeight / iZoomed;
-		int minTrackHeight = SNM_GetIconTheme()->tcp_small_height;
-		int iLanesHeight = 0;
-		while (true)
-		{
-			iLanesHeight = 0;
-			// Calc envelope height
-			for (int i = 0; i < iNum; i++)
+			// Pixels we have to work with will all the sel tracks and their envelopes
+			iTotalHeight -= iNotZoomedSize;
+			int minTrackHeight = SNM_GetIconTheme()->tcp_small_height;
+
+			// Biggest height so that zoomed tracks + their lanes fit (the total height grows with the track height)
+			int iEachHeight = minTrackHeight - 1;
+			if (iZoomed)
 			{
-				if (bZoomed[i] && i + iFirst <= lastTrackId) // don't check envelope lanes height for the last track if includeEnvelopes == true
-					iLanesHeight += CountTrackEnvelopePanels(CSurf_TrackFromID(i + iFirst, false)) * GetEnvHeightFromTrackHeight(iEachHeight);
+				int lo = minTrackHeight, hi = iTotalHeight / iZoomed;
+				while (lo <= hi)
+				{
+					int mid = lo + (hi - lo) / 2;
+					if (mid * iZoomed + iLanes * GetEnvHeightFromTrackHeight(mid) <= iTotalHeight)
+					{
+						iEachHeight = mid;
+						lo = mid + 1;
+					}
+					else
+						hi = mid - 1;
+				}
 			}
-			if (iEachHeight * iZoomed + iLanesHeight <= iTotalHeight)
-				break;
 
-			// Guess new iEachHeight - may be wrong!
-			int iNewEachHeight = (int)(iTotalHeight / ((double)iLanesHeight / iEachHeight + iZoomed));
-			if (iNewEachHeight == iEachHeight)
-				iEachHeight--;
-			else
-				iEachHeight = iNewEachHeight;
+			// Check track is over minimum and make sure last track fills the TCP exactly to the bottom
+			int leftOverHeight = 0;
 			if (iEachHeight < minTrackHeight)
-				break;
-		}
-
-		// Check track is over minimum and make sure last track fills the TCP exactly to the bottom
-		int leftOverHeight = 0;
-		if (iEachHeight < minTrackHeight)
-		{
-			iEachHeight = minTrackHeight;
-		}
-		else
-		{
-			leftOverHeight = iTotalHeight - (iEachHeight * iZoomed) - iLanesHeight;
-			if (iEachHeight + leftOverHeight >= (int) (iEachHeight * 1.5)) // if leftover height is to big, just leave it cropped (this is the same mechanism REAPER uses for take heights within the item)
-				leftOverHeight = 0;
-
-		}
-
-		for (int i = 0; i < iNum; i++)
-		{
-			if (bZoomed[i])
 			{
-				if (i + 1 == iNum)
-					iEachHeight +=leftOverHeight;
-				GetSetMediaTrackInfo(CSurf_TrackFromID(i+iFirst, false), "I_HEIGHTOVERRIDE", &iEachHeight);
+				iEachHeight = minTrackHeight;
+			}
+			else
+			{
+				leftOverHeight = iTotalHeight - (iEachHeight * iZoomed) - iLanes * GetEnvHeightFromTrackHeight(iEachHeight);
+				if (iEachHeight + leftOverHeight >= (int) (iEachHeight * 1.5)) // if leftover height is to big, just leave it cropped (this is the same mechanism REAPER uses for take heights within the item)
+					leftOverHeight = 0;
 			}
+
+			for (int i = 0; i < iNum; i++)
+				if (bZoomed[i])
+					trans.Set(tracks[i].tr, "I_HEIGHTOVERRIDE", (double)(i + 1 == iNum ? iEachHeight + leftOverHeight : iEachHeight));
 		}
-		TrackList_AdjustWindows(false);
-		UpdateTimeline();
-	}
-	else
-	{
-		vector<vector<int> > envelopeHeights;
-		for (int i = 0; i < iNum; i++)
+		else
 		{
-			if (i+iFirst <= lastTrackId) // don't check envelope lanes height for the last track if includeEnvelopes == true
+			for (int i = 0; i < iNum; i++)
 			{
-				vector<int> tmp;
-				envelopeHeights.push_back(tmp);
-				MediaTrack* tr = CSurf_TrackFromID(i+iFirst, false);
-				if (TcpVis(tr))
+				VZoomTrack& t = tracks[i];
+				if (i+iFirst <= lastTrackId && t.bVis) // don't check envelope lanes height for the last track if includeEnvelopes == true
 				{
-					for (int j = 0; j < CountTrackEnvelopes(tr); j++)
+					for (int j = 0; j < CountTrackEnvelopes(t.tr); j++)
 					{
-						BR_Envelope envelope(GetTrackEnvelope(tr, j));
+						BR_Envelope envelope(GetTrackEnvelope(t.tr, j));
 						if (envelope.IsInLane())
-							envelopeHeights.back().push_back(envelope.GetLaneHeight());
+							t.envHeights.push_back(envelope.GetLaneHeight());
 					}
 				}
 			}
-		}
 
-		int iZoom = VZOOM_RANGE+1;
-		int iHeight;
-		do
-		{
-			iZoom--;
-			iHeight = 0;
-			for (int i = 0; i < iNum; i++)
+			// Biggest zoom level that fits (0 if none)
+			int iZoom = 0;
+			int lo = 0, hi = VZOOM_RANGE;
+			while (lo <= hi)
 			{
-				MediaTrack* tr = CSurf_TrackFromID(i+iFirst, false);
-				if (TcpVis(tr))
+				int mid = lo + (hi - lo) / 2;
+				if (GetVZoomRangeHeight(tracks, mid) <= iTotalHeight)
 				{
-					int trackHeight = GetTrackHeightFromVZoomIndex(tr, iZoom);
-
-					int envHeight = 0;
-					if (i < (int)envelopeHeights.size())
-					{
-						for (size_t j = 0; j < envelopeHeights[i].size(); j++)
-						{
-							int h = envelopeHeights[i][j];
-							envHeight += (h != 0) ? h : GetEnvHeightFromTrackHeight(trackHeight);
-						}
-					}
-					iHeight += trackHeight + envHeight;
-					if (tr == masterTrack && TcpVis(tr) && iNum > 1) iHeight += GetMasterTcpGap();
+					iZoom = mid;
+					lo = mid + 1;
 				}
+				else
+					hi = mid - 1;
 			}
-		} while (iHeight > iTotalHeight && iZoom > 0);
 
-		// Reset custom track sizes
-		for (int i = 0; i <= GetNumTracks(); i++)
-			GetSetMediaTrackInfo(CSurf_TrackFromID(i, false), "I_HEIGHTOVERRIDE", &g_i0);
-		*ConfigVar<int>("vzoom2") = iZoom;
-		TrackList_AdjustWindows(false);
-		UpdateTimeline();
-	}
+			// Reset custom track sizes
+			for (int i = 0; i <= GetNumTracks(); i++)
+				trans.Set(CSurf_TrackFromID(i, false), "I_HEIGHTOVERRIDE", 0.0);
+			*ConfigVar<int>("vzoom2") = iZoom;
+		}
 
+		if (!trans.Commit()) // vzoom2 may have changed anyway
+		{
+			TrackList_AdjustWindows(false);
+			UpdateTimeline();
+		}
+	}
 
 	SetVertPos(hTrackView, iFirst, false);
 }
@@ -824,6 +847,51 @@ static SWSProjConfig<int> g_zoomLevel;
 static bool g_bUndoSWSOnly = false;
 static bool g_bLastUndoProj = false;
 
+// Cheap change signals polled every slice, the zoom state (track heights) is only captured when one of
+// them changes. Track height changes show in the vertical scroll range, track add/remove/reorder and
+// project tab changes in the track list change counter.
+static int g_iTrackListChanges = 0;
+
+struct ZoomSignals
+{
+	ReaProject* proj;
+	double dHZoom;
+	int iVZoom, iVRange, iVPage, iNumTracks, iTrackListChanges;
+	int iVPos, iHPos;
+
+	void Get()
+	{
+		memset(this, 0, sizeof(ZoomSignals));
+		proj = EnumProjects(-1, NULL, 0);
+		dHZoom = GetHZoomLevel();
+		iVZoom = *ConfigVar<int>("vzoom2");
+		iNumTracks = GetNumTracks();
+		iTrackListChanges = g_iTrackListChanges;
+		if (HWND hTrackView = GetTrackWnd())
+		{
+			SCROLLINFO si = { sizeof(SCROLLINFO), };
+			si.fMask = SIF_ALL;
+			CoolSB_GetScrollInfo(hTrackView, SB_VERT, &si);
+			iVRange = si.nMax - si.nMin;
+			iVPage = si.nPage;
+			iVPos = si.nPos;
+			CoolSB_GetScrollInfo(hTrackView, SB_HORZ, &si);
+			iHPos = si.nPos;
+		}
+	}
+	bool IsZoomEqual(const ZoomSignals& zs) const
+	{
+		return zs.proj == proj && zs.dHZoom == dHZoom && zs.iVZoom == iVZoom && zs.iVRange == iVRange &&
+			zs.iVPage == iVPage && zs.iNumTracks == iNumTracks && zs.iTrackListChanges == iTrackListChanges;
+	}
+	bool IsPosEqual(const ZoomSignals& zs) const { return zs.iVPos == iVPos && zs.iHPos == iHPos; }
+};
+
+void ZoomTrackListChange()
+{
+	g_iTrackListChanges++;
+}
+
 // Save the current zoom state, called from the slice
 void SaveZoomSlice(bool bSWS)
 {
@@ -831,6 +899,20 @@ void SaveZoomSlice(bool bSWS)
 	if (g_zoomStack.Get()->GetSize() == 0)
 		*g_zoomLevel.Get() = 0;
 
+	static ZoomSignals lastSignals = { NULL, };
+	ZoomSignals signals;
+	signals.Get();
+
+	// Slice with no zoom change: only keep track of the position (if it moved at all)
+	if (!bSWS && g_zoomStack.Get()->GetSize() && signals.IsZoomEqual(lastSignals))
+	{
+		if (!signals.IsPosEqual(lastSignals))
+			g_zoomStack.Get()->Get(*g_zoomLevel.Get())->SavePos();
+		lastSignals = signals;
+		return;
+	}
+	lastSignals = signals;
+
 	static ZoomState* zs = NULL;
 	if (!zs)
 		zs = new ZoomState;
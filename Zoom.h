@@ -28,6 +28,7 @@
 #pragma once
 
 void ZoomSlice();
+void ZoomTrackListChange();
 int ZoomInit(bool hookREAPERWndProcs);
 void ZoomExit();
 void ZoomToSelItems(COMMAND_T* = NULL);
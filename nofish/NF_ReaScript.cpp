@@ -263,6 +263,77 @@ bool NF_AnalyzeMediaItemPeakAndRMS(MediaItem* item, double windowSize, void* rea
 	return success;
 }
 
+bool NF_AnalyzeMediaItem(MediaItem* item, double windowSize, bool analyzeLoudness, double* peakOut, double* peakPosOut, double* averageRMSOut, double* peakRMSOut, double* peakRMSWindowedOut, double* peakRMSWindowedPosOut, double* lufsIntegratedOut, double* rangeOut, double* shortTermMaxOut, double* momentaryMaxOut)
+{
+	WritePtr(peakOut, -150.0);
+	WritePtr(peakPosOut, 0.0);
+	WritePtr(averageRMSOut, -150.0);
+	WritePtr(peakRMSOut, -150.0);
+	WritePtr(peakRMSWindowedOut, -150.0);
+	WritePtr(peakRMSWindowedPosOut, -666.0);
+	WritePtr(lufsIntegratedOut, -150.0);
+	WritePtr(rangeOut, 0.0);
+	WritePtr(shortTermMaxOut, -150.0);
+	WritePtr(momentaryMaxOut, -150.0);
+
+	if (!item)
+		return false;
+
+	const double samplerate = ((PCM_source*)item)->GetSampleRate();
+	const int iChannels = ((PCM_source*)item)->GetNumChannels();
+	if (samplerate == 0.0 || !iChannels)
+		return false;
+
+	ANALYZE_PCM a;
+	memset(&a, 0, sizeof(a));
+	a.iChannels = iChannels;
+	a.dAvgRMSs = new double[iChannels];
+	a.dWindowSize = windowSize;
+	if (a.dWindowSize <= 0.0)
+		NF_GetRMSOptions(NULL, &a.dWindowSize);
+
+	if (analyzeLoudness)
+		a.loudness = ebur128_init((unsigned int)iChannels, (unsigned long)samplerate, EBUR128_MODE_M | EBUR128_MODE_S | EBUR128_MODE_I | EBUR128_MODE_LRA);
+
+	const bool success = AnalyzeItem(item, &a);
+	if (success)
+	{
+		double maxRMS = 0.0;
+		for (int i = 0; i < iChannels; i++)
+			maxRMS = max(maxRMS, a.dAvgRMSs[i]);
+
+		WritePtr(peakOut, VAL2DB(a.dPeakVal));
+		WritePtr(peakPosOut, GetPosInItem(a.peakSample, samplerate));
+		WritePtr(averageRMSOut, VAL2DB(a.dAvgRMS));
+		WritePtr(peakRMSOut, VAL2DB(maxRMS));
+
+		// AnalyzeItem() falls back to non-windowed mode if the window is longer than the item
+		if (a.peakRMSsample != -666)
+		{
+			WritePtr(peakRMSWindowedOut, VAL2DB(a.dRMS));
+			WritePtr(peakRMSWindowedPosOut, GetPosInItem(a.peakRMSsample, samplerate));
+		}
+
+		if (a.loudness)
+		{
+			double integrated, range;
+			if (ebur128_loudness_global(a.loudness, &integrated) == EBUR128_SUCCESS && integrated != -HUGE_VAL)
+				WritePtr(lufsIntegratedOut, integrated);
+			if (ebur128_loudness_range(a.loudness, &range) == EBUR128_SUCCESS)
+				WritePtr(rangeOut, range);
+			if (a.dShortTermMax != -HUGE_VAL)
+				WritePtr(shortTermMaxOut, a.dShortTermMax);
+			if (a.dMomentaryMax != -HUGE_VAL)
+				WritePtr(momentaryMaxOut, a.dMomentaryMax);
+		}
+	}
+
+	if (a.loudness)
+		ebur128_destroy(&a.loudness);
+	delete[] a.dAvgRMSs;
+	return success;
+}
+
 double GetPosInItem(INT64 peakSample, double sampleRate) // relative to item start
 {	
 	if (peakSample == -666)
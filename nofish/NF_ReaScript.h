@@ -36,6 +36,8 @@ double          NF_GetMediaItemPeakRMS_NonWindowed(MediaItem* item);
 double          NF_GetMediaItemPeakRMS_Windowed(MediaItem* item);
                 // combines all above functions
 bool            NF_AnalyzeMediaItemPeakAndRMS(MediaItem* item, double windowSize, void* reaperarray_peaks, void* reaperarray_peakpositions, void* reaperarray_RMSs, void* reaperarray_RMSpositions);
+                // single pass over the item for all of the above (+ optional loudness)
+bool            NF_AnalyzeMediaItem(MediaItem* item, double windowSize, bool analyzeLoudness, double* peakOut, double* peakPosOut, double* averageRMSOut, double* peakRMSOut, double* peakRMSWindowedOut, double* peakRMSWindowedPosOut, double* lufsIntegratedOut, double* rangeOut, double* shortTermMaxOut, double* momentaryMaxOut);
 
 // #880
 bool            NF_AnalyzeTakeLoudness_IntegratedOnly(MediaItem_Take* take, double* lufsIntegratedOut);
@@ -75,6 +75,13 @@ static WDL_IntKeyedArray<WDL_String*> g_cmdFiles(freeCmdFilesValue);
 #endif
 static WDL_IntKeyedArray<COMMAND_T*> g_commands; // no valdispose (cmds can be allocated in different ways)
 
+// Lookup indexes, maintained on (un)registration
+// g_cmdsByName: main section custom ids (without leading '_') -> cmd id
+// g_cmdsByFunc: doCommand/user -> cmd ids (several cmds can share the same function pointer)
+static WDL_StringKeyedArray<int> g_cmdsByName(true);
+typedef std::pair<void(*)(COMMAND_T*), INT_PTR> SWSCmdFuncKey;
+static std::map<SWSCmdFuncKey, std::set<int> > g_cmdsByFunc;
+
 int g_iFirstCommand = 0;
 int g_iLastCommand = 0;
 
@@ -262,6 +269,9 @@ int SWSRegisterCmd(COMMAND_T* pCommand, const char* cFile, int cmdId, bool local
 	if (cmdId > g_iLastCommand) g_iLastCommand = cmdId;
 
 	g_commands.Insert(cmdId, pCommand);
+	if (!pCommand->uniqueSectionId && pCommand->doCommand)
+		g_cmdsByName.Insert(pCommand->id, cmdId);
+	g_cmdsByFunc[SWSCmdFuncKey(pCommand->doCommand, pCommand->user)].insert(cmdId);
 #ifdef ACTION_DEBUG
 	g_cmdFiles.Insert(cmdId, new WDL_String(cFile));
 #endif
@@ -328,6 +338,15 @@ COMMAND_T* SWSUnregisterCmd(int id)
 			plugin_register("-custom_action", (void*)&s);
 		}
 		g_commands.Delete(id);
+		if (g_cmdsByName.Get(ct->id, 0) == id)
+			g_cmdsByName.Delete(ct->id);
+		std::map<SWSCmdFuncKey, std::set<int> >::iterator it = g_cmdsByFunc.find(SWSCmdFuncKey(ct->doCommand, ct->user));
+		if (it != g_cmdsByFunc.end())
+		{
+			it->second.erase(id);
+			if (it->second.empty())
+				g_cmdsByFunc.erase(it);
+		}
 #ifdef ACTION_DEBUG
 		g_cmdFiles.Delete(id);
 #endif
@@ -372,23 +391,31 @@ void ActionsList(COMMAND_T*)
 
 //JFB questionnable func: ok most of the time but, for ex.,
 // 2 different cmds can share the same function pointer cmd->doCommand
+// returns the lowest matching cmd id, like the former enumeration of g_commands did
 int SWSGetCommandID(void (*cmdFunc)(COMMAND_T*), INT_PTR user, const char** pMenuText)
 {
-	for (int i=0; i<g_commands.GetSize(); i++)
+	std::map<SWSCmdFuncKey, std::set<int> >::iterator it = g_cmdsByFunc.find(SWSCmdFuncKey(cmdFunc, user));
+	if (it != g_cmdsByFunc.end() && !it->second.empty())
 	{
-		if (COMMAND_T* cmd = g_commands.Enumerate(i, NULL, NULL))
+		if (COMMAND_T* cmd = g_commands.Get(*it->second.begin(), NULL))
 		{
-			if (cmd->doCommand == cmdFunc && cmd->user == user)
-			{
-				if (pMenuText)
-					*pMenuText = cmd->menuText;
-				return cmd->accel.accel.cmd;
-			}
+			if (pMenuText)
+				*pMenuText = cmd->menuText;
+			return cmd->accel.accel.cmd;
 		}
 	}
 	return 0;
 }
 
+// Main section SWS actions only, _custId with or without leading '_'
+// returns 0 if not found (i.e. not a SWS action, use NamedCommandLookup() then)
+int SWSGetCommandIDByName(const char* _custId)
+{
+	if (!_custId || !*_custId)
+		return 0;
+	return g_cmdsByName.Get(*_custId == '_' ? _custId+1 : _custId, 0);
+}
+
 COMMAND_T* SWSGetCommandByID(int cmdId) {
 	if (cmdId >= g_iFirstCommand && cmdId <= g_iLastCommand) // not enough to ensure it is a SWS action
 		return g_commands.Get(cmdId, NULL);
@@ -464,6 +491,82 @@ static void swsMenuHook(const char* menustr, HMENU hMenu, int flag)
 
 
 
+// Periodic main thread tasks, run from SWSTimeSlice::Run() in registration order.
+// Critical tasks run on every time slice. Other tasks run when due (m_interval, 0 = every slice)
+// and only while the slice's budget is not exhausted (low priority tasks only get half of it),
+// otherwise they are deferred to the next slice (but never more than SWS_TIMESLICE_MAX_DEFER
+// slices in a row).
+#define SWS_TIMESLICE_BUDGET_US		4000 // well below a 60fps UI frame
+#define SWS_TIMESLICE_MAX_DEFER		20
+
+enum { SWS_TASK_CRITICAL=0, SWS_TASK_NORMAL, SWS_TASK_LOW };
+
+struct SWSTimeSliceTask
+{
+	const char* m_name;
+	void (*m_run)();
+	int m_priority;
+	double m_interval; // seconds
+
+	// state/timing counters
+	double m_lastRun;
+	int m_deferredSlices;
+	unsigned int m_runs, m_deferred;
+	double m_totalUs, m_maxUs;
+};
+
+static void TrackListChangedRun();
+
+static SWSTimeSliceTask g_timeSliceTasks[] =
+{
+	{ "S&M playlist/scheduled jobs", SNM_CSurfRun,        SWS_TASK_CRITICAL, 0.0, }, // region playlist must not miss a slice
+	{ "Zoom history",                ZoomSlice,           SWS_TASK_NORMAL,   0.0, },
+	{ "Edit cursor history",         MiscSlice,           SWS_TASK_NORMAL,   0.0, },
+	{ "S&M markers/toolbars",        SNM_CSurfIdleRun,    SWS_TASK_LOW,      0.1, }, // toolbar refresh is >= 100ms, markers 500ms
+	{ "Track list change",           TrackListChangedRun, SWS_TASK_LOW,      0.1, }, // list windows refresh, coalesces bursts of changes
+};
+
+static void RunTimeSliceTasks()
+{
+	const double sliceStart = time_precise();
+	for (int i=0; i < (int)(sizeof(g_timeSliceTasks)/sizeof(SWSTimeSliceTask)); i++)
+	{
+		SWSTimeSliceTask* task = &g_timeSliceTasks[i];
+		const double now = time_precise();
+		if (task->m_interval > 0.0 && now - task->m_lastRun < task->m_interval)
+			continue;
+
+		if (task->m_priority != SWS_TASK_CRITICAL && (now - sliceStart) * 1000000.0 > SWS_TIMESLICE_BUDGET_US / task->m_priority &&
+			task->m_deferredSlices < SWS_TIMESLICE_MAX_DEFER)
+		{
+			task->m_deferredSlices++;
+			task->m_deferred++;
+			continue;
+		}
+
+		task->m_run();
+
+		const double end = time_precise(), us = (end - now) * 1000000.0;
+		task->m_lastRun = now;
+		task->m_deferredSlices = 0;
+		task->m_runs++;
+		task->m_totalUs += us;
+		if (us > task->m_maxUs)
+			task->m_maxUs = us;
+	}
+}
+
+void GetTimeSliceStats(WDL_FastString* stats)
+{
+	stats->Set("");
+	for (int i=0; i < (int)(sizeof(g_timeSliceTasks)/sizeof(SWSTimeSliceTask)); i++)
+	{
+		SWSTimeSliceTask* task = &g_timeSliceTasks[i];
+		stats->AppendFormatted(256, "%s: %u runs, avg %.1f us, max %.1f us, %u deferred\n",
+			task->m_name, task->m_runs, task->m_runs ? task->m_totalUs / task->m_runs : 0.0, task->m_maxUs, task->m_deferred);
+	}
+}
+
 // Fake control surface to get a low priority periodic time slice from Reaper
 // and callbacks for some "track params have changed"
 class SWSTimeSlice : public IReaperControlSurface
@@ -479,10 +582,11 @@ public:
 
 	void Run() // BR: Removed some stuff from here and made it use plugin_register("timer"/"-timer") - it's the same thing as this but it enables us to remove unused stuff completely
 	{          // I guess we could do the rest too (and add user options to enable where needed)...
-		SNM_CSurfRun();
-		ZoomSlice();
-		MiscSlice();
+		RunTimeSliceTasks();
+	}
 
+	void TrackListChangedRun()
+	{
 		if (m_bChanged)
 		{
 			m_bChanged = false;
@@ -505,6 +609,9 @@ public:
 	void SetTrackListChange()
 	{
 		m_bChanged = true;
+		ZoomTrackListChange();
+		TracklistFilterSetTrackListChange();
+		ConsoleTrackListChange();
 		AutoColorTrack(false);
 		AutoColorMarkerRegion(false);
 		SNM_CSurfSetTrackListChange();
@@ -515,6 +622,8 @@ public:
 	// However, we still need to trap track name changes with no track list change.
 	void SetTrackTitle(MediaTrack *tr, const char *c)
 	{
+		TracklistFilterSetTrackTitle(tr);
+		ConsoleTrackListChange();
 		ScheduleTracklistUpdate();
 		if (!m_iACIgnore)
 		{
@@ -602,6 +711,12 @@ void WDL_STYLE_ScaleImageCoords(int *x, int *y) { }
 
 SWSTimeSlice* g_ts=NULL;
 
+static void TrackListChangedRun()
+{
+	if (g_ts)
+		g_ts->TrackListChangedRun();
+}
+
 void ErrMsg(const char* errmsg, bool wantblabla=true)
 {
 	if (errmsg && *errmsg && (!IsREAPER || IsREAPER())) // don't display any message if loaded from ReaMote
@@ -1131,6 +1246,7 @@ error:
 
 		// Optional API functions (check for NULL if using!) 
 		IMPAP_OPT(GetEnvelopeInfo_Value); // 5.982+
+		IMPAP_OPT(GetAudioDeviceInfo);
 
 		// Look for SWS dupe/clone
 		if (rec->GetFunc("SNM_GetIntConfigVar"))
@@ -302,6 +302,52 @@ void SetTrackVis(MediaTrack* tr, int vis) // &1 == mcp, &2 == tcp
 	}
 }
 
+void SWS_TrackTransaction::Set(MediaTrack* tr, const char* parm, double val)
+{
+	if (!tr || !parm || m_bCommitted)
+		return;
+	std::pair<std::map<std::pair<MediaTrack*, std::string>, int>::iterator, bool> it =
+		m_idx.insert(std::make_pair(std::make_pair(tr, std::string(parm)), m_writes.GetSize()));
+	if (!it.second)
+	{
+		m_writes.Get()[it.first->second].val = val;
+		return;
+	}
+	TrackWrite w = { tr, it.first->first.second.c_str(), val }; // map keys are stable until Commit()
+	m_writes.Add(w);
+}
+
+bool SWS_TrackTransaction::Commit()
+{
+	if (m_bCommitted)
+		return false;
+	m_bCommitted = true;
+
+	bool bChanged = false, bLayout = false;
+	for (int i = 0; i < m_writes.GetSize(); i++)
+	{
+		TrackWrite* w = m_writes.Get() + i;
+		if (GetMediaTrackInfo_Value(w->tr, w->parm) != w->val)
+		{
+			SetMediaTrackInfo_Value(w->tr, w->parm, w->val);
+			bChanged = true;
+			if (!strcmp(w->parm, "I_HEIGHTOVERRIDE") || !strcmp(w->parm, "B_HEIGHTLOCK") ||
+				!strcmp(w->parm, "B_SHOWINTCP") || !strcmp(w->parm, "B_SHOWINMIXER") ||
+				!strcmp(w->parm, "I_FOLDERDEPTH") || !strcmp(w->parm, "I_FOLDERCOMPACT"))
+				bLayout = true;
+		}
+	}
+	m_writes.Resize(0, false);
+	m_idx.clear();
+
+	if (bLayout)
+		TrackList_AdjustWindows(false);
+	if (bChanged)
+		UpdateTimeline();
+	PreventUIRefresh(-1);
+	return bChanged;
+}
+
 HWND GetTrackWnd()
 {
 	return GetArrangeWnd(); // BR: will take care of any localization issues
@@ -204,10 +204,14 @@ bool SWSFreeUnregisterDynamicCmd(int id);
 void ActionsList(COMMAND_T*);
 int SWSGetCommandID(void (*cmdFunc)(COMMAND_T*), INT_PTR user = 0, const char** pMenuText = NULL);
 COMMAND_T* SWSGetCommandByID(int cmdId);
+int SWSGetCommandIDByName(const char* _custId);
 int IsSwsAction(const char* _actionName);
 
 HMENU SWSCreateMenuFromCommandTable(COMMAND_T pCommands[], HMENU hMenu = NULL, int* iIndex = NULL);;
 
+// Main thread time slice, sws_extension.cpp
+void GetTimeSliceStats(WDL_FastString* stats); // per task timing counters
+
 // Utility functions, sws_util.cpp
 BOOL IsCommCtrlVersion6();
 void SaveWindowPos(HWND hwnd, const char* cKey);
@@ -224,12 +228,29 @@ int GetFolderDepth(MediaTrack* tr, int* iType, MediaTrack** nextTr);
 int GetTrackVis(MediaTrack* tr); // &1 == mcp, &2 == tcp
 void SetTrackVis(MediaTrack* tr, int vis); // &1 == mcp, &2 == tcp
 int AboutBoxInit(); // Not worth its own .h
+
+// Collects track property writes (the last write of a track/param pair wins) and applies them
+// in one pass under a single PreventUIRefresh(), refreshing track layout/timeline once on Commit()
+class SWS_TrackTransaction
+{
+public:
+	SWS_TrackTransaction() : m_bCommitted(false) { PreventUIRefresh(1); }
+	~SWS_TrackTransaction() { Commit(); }
+	void Set(MediaTrack* tr, const char* parm, double val);
+	bool Commit(); // returns true if something was changed (i.e. undo point needed)
+private:
+	struct TrackWrite { MediaTrack* tr; const char* parm; double val; }; // parm points to the m_idx key's copy
+	WDL_TypedBuf<TrackWrite> m_writes;
+	std::map<std::pair<MediaTrack*, std::string>, int> m_idx;
+	bool m_bCommitted;
+};
 HWND GetTrackWnd();
 HWND GetRulerWnd();
 const GUID* TrackToGuid(MediaTrack* tr);
 MediaTrack* GuidToTrack(const GUID* guid);
 bool GuidsEqual(const GUID* g1, const GUID* g2);
 bool TrackMatchesGuid(MediaTrack* tr, const GUID* g);
+struct GUIDLess { bool operator()(const GUID& a, const GUID& b) const { return memcmp(&a, &b, sizeof(GUID)) < 0; } }; // for std::map<GUID, ...>
 const char *stristr(const char* a, const char* b);
 
 // NF: fix / workaround for setting take start offset doesn't work if containing stretch markers
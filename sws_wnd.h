@@ -50,22 +50,48 @@ typedef struct SWS_LVColumn
 
 class SWS_ListItem; // abstract.  At some point it might make sense to make this a real class?
 
+// Items are only sorted (by pointer) when first searched, and deleted items are just flagged,
+// so that filling/diffing a list of n items is O(n log n)
 class SWS_ListItemList
 {
 public:
-	SWS_ListItemList() {}
+	SWS_ListItemList():m_bSorted(true),m_iLive(0) {}
 	~SWS_ListItemList() {}
-	int GetSize() { return m_list.GetSize(); }
-	void Add(SWS_ListItem* item, bool sort = true) { if (sort) m_list.InsertSorted(item, ILIComp); else m_list.Add(item); }
-	SWS_ListItem* Get(int iIndex) { return (SWS_ListItem*)m_list.Get(iIndex); }
-	int Find(SWS_ListItem* item) { return m_list.FindSorted(item, ILIComp); }
-	void Delete(int iIndex) { m_list.Delete(iIndex); }
+	int GetSize() { return m_iLive; }
+	void Add(SWS_ListItem* item, bool sort = true) { Compact(); m_list.Add(item); m_iLive++; if (sort) m_bSorted = false; }
+	SWS_ListItem* Get(int iIndex) { Compact(); return (SWS_ListItem*)m_list.Get(iIndex); } // live items only, like GetSize()
+	int Find(SWS_ListItem* item) { Sort(); int i = m_list.FindSorted(item, ILIComp); return i >= 0 && !IsDeleted(i) ? i : -1; }
+	void Delete(int iIndex) { if (iIndex >= 0 && iIndex < m_list.GetSize() && !IsDeleted(iIndex)) { SetDeleted(iIndex); m_iLive--; } }
 	// Remove returns and also removes the last item.  It's the last because it's more efficient to remove at the end.
-	SWS_ListItem* Remove() { if (!m_list.GetSize()) return NULL; int last = m_list.GetSize()-1; SWS_ListItem* item = (SWS_ListItem*)m_list.Get(last); m_list.Delete(last); return item; }
-	void Empty() { m_list.Empty(); }
+	SWS_ListItem* Remove()
+	{
+		Sort();
+		while (m_list.GetSize() && IsDeleted(m_list.GetSize()-1)) { m_list.Delete(m_list.GetSize()-1); m_deleted.Resize(m_list.GetSize()); }
+		if (!m_list.GetSize()) return NULL;
+		int last = m_list.GetSize()-1; SWS_ListItem* item = (SWS_ListItem*)m_list.Get(last);
+		m_list.Delete(last); m_deleted.Resize(last); m_iLive--;
+		return item;
+	}
+	void Empty() { m_list.Empty(); m_deleted.Resize(0); m_iLive = 0; m_bSorted = true; }
 private:
 	static int ILIComp(const SWS_ListItem** a, const SWS_ListItem** b) { return (*a > *b ? 1 : *a < *b ? -1 : 0); };
+	static int ILISortComp(const void* a, const void* b) { return ILIComp((const SWS_ListItem**)a, (const SWS_ListItem**)b); }
+	bool IsDeleted(int i) { return i < m_deleted.GetSize() && m_deleted.Get()[i]; }
+	void SetDeleted(int i) { if (m_deleted.GetSize() < m_list.GetSize()) { int sz = m_deleted.GetSize(); m_deleted.Resize(m_list.GetSize()); memset(m_deleted.Get()+sz, 0, m_list.GetSize()-sz); } m_deleted.Get()[i] = 1; }
+	void Compact()
+	{
+		if (!m_deleted.GetSize()) return;
+		int j = 0;
+		for (int i = 0; i < m_list.GetSize(); i++)
+			if (!IsDeleted(i)) m_list.GetList()[j++] = m_list.Get(i);
+		while (m_list.GetSize() > j) m_list.Delete(m_list.GetSize()-1);
+		m_deleted.Resize(0);
+	}
+	void Sort() { if (!m_bSorted) { Compact(); qsort(m_list.GetList(), m_list.GetSize(), sizeof(SWS_ListItem*), ILISortComp); m_bSorted = true; } }
 	WDL_PtrList<SWS_ListItem> m_list;
+	WDL_TypedBuf<char> m_deleted;
+	bool m_bSorted;
+	int m_iLive;
 };
 
 class SWS_ListView